@@ -0,0 +1,63 @@
+#ifndef ANALYTICS_H
+#define ANALYTICS_H
+
+#include <utility>
+#include <vector>
+
+#include "geom.hpp"
+
+//A triangulation with every corner replaced by the index of its site, so
+//topology can be walked with integer comparisons instead of matching
+//Points and LineSegments by value
+class IndexedTriangulation {
+    public:
+    std::vector<Point> sites;
+    std::vector<int> corners;    //3 site indices per triangle
+    IndexedTriangulation(const std::vector<Point>& sites, const std::vector<Triangle>& triangles);
+    int numTriangles() const;
+};
+
+//Site adjacency in compressed sparse row form: the neighbors of site i are
+//neighbors[offsets[i]] up to (not including) neighbors[offsets[i + 1]]
+class SiteGraph {
+    public:
+    std::vector<int> offsets;
+    std::vector<int> neighbors;
+    int degree(int site) const;
+};
+
+class CellStats {
+    public:
+    double area;
+    Point centroid;
+    bool bounded;   //false for hull sites, whose cells run off to infinity
+};
+
+SiteGraph buildSiteGraph(const IndexedTriangulation& tri);
+
+//Area and centroid of every Voronoi cell, straight from the triangulation.
+//Unbounded cells get bounded = false, area 0 and the site as centroid.
+std::vector<CellStats> cellStats(const IndexedTriangulation& tri, int numThreads);
+
+//Area and centroid of cells from delauneyToVoronoi(). Each edge adds the
+//triangle it makes with the site, so edge order doesn't matter; the result
+//covers whatever part of the cell its edges enclose. Cells of sites on the
+//convex hull of all the cells' sites are unbounded, whatever part of them
+//delauneyToVoronoi() kept inside its drawing bounds.
+std::vector<CellStats> cellStats(const std::vector<Cell>& cells, int numThreads);
+
+//Number of triangles in any triangulation of sites: 2n - 2 - h for n
+//distinct sites of which h lie on the convex hull's boundary, or 0 if they
+//are all collinear. A triangulation with fewer is missing some.
+int expectedTriangleCount(const std::vector<Point>& sites);
+
+//Distinct sites on the convex hull's boundary, including those along its
+//edges, ordered by x then y. All of them if the sites are collinear.
+std::vector<Point> hullSites(const std::vector<Point>& sites);
+
+//Euclidean minimum spanning tree of the sites as pairs of site indices.
+//The EMST is a subgraph of the Delaunay triangulation, so only its edges
+//are considered.
+std::vector<std::pair<int, int>> euclideanMST(const IndexedTriangulation& tri);
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <vector>
+
+#include "geom.hpp"
+#include "predicates.hpp"
+
+//Working storage for one run of delauney(). Reusing the same scratch across
+//many calls means the vectors only grow to the largest diagram seen instead
+//of being reallocated for every diagram and every inserted point.
+class DelauneyScratch {
+    public:
+    std::vector<Point> sites;               //input sorted by x
+    std::vector<GridPoint> gridVerts;       //supertriangle corners then sites,
+    std::vector<FloatPoint> floatVerts;     //in whichever coordinate type the
+    std::vector<DoublePoint> doubleVerts;   //run uses
+    std::vector<int> triangles;             //3 vertex indices per triangle, counterclockwise
+    std::vector<int> edges;                 //2 vertex indices per cavity edge
+    void clear();
+
+    std::vector<GridPoint>& verts(int32_t) { return gridVerts; }
+    std::vector<FloatPoint>& verts(float) { return floatVerts; }
+    std::vector<DoublePoint>& verts(double) { return doubleVerts; }
+};
+
+//Triangulates every point set in pointSets, spreading the sets across
+//numThreads workers (numThreads <= 0 means one per core). Each worker keeps
+//its own DelauneyScratch, and results[i] holds the triangulation of
+//pointSets[i] exactly as delauney(pointSets[i]) would return it.
+std::vector<std::vector<Triangle>> delauneyBatch(const std::vector<std::vector<Point>>& pointSets, int numThreads);
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef GENERATE_H
+#define GENERATE_H
+
+#include <cstdint>
+#include <vector>
+
+#include "geom.hpp"
+
+//Counter based random numbers. at(i) is a pure function of the stream key
+//and i (it is the i-th output of a SplitMix64 sequence started at key), so
+//any thread can produce any element of a stream without touching shared
+//state, and the result doesn't depend on how the work was divided.
+class RandomStream {
+    public:
+    uint64_t key;
+
+    static uint64_t mix(uint64_t z) {
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+    RandomStream(uint64_t seed, uint64_t stream) : key(mix(seed ^ mix(stream + 0x9e3779b97f4a7c15ULL))) {}
+
+    //Independent child stream, e.g. one per cluster or grid cell
+    RandomStream split(uint64_t child) const { return RandomStream(key, child); }
+
+    uint64_t at(uint64_t counter) const { return mix(key + (counter + 1) * 0x9e3779b97f4a7c15ULL); }
+
+    //Uniform double in [0, 1)
+    double uniform(uint64_t counter) const { return (at(counter) >> 11) * (1.0 / 9007199254740992.0); }
+};
+
+//Points stored as separate x and y arrays so generators can fill them with
+//plain strided writes
+class PointBuffer {
+    public:
+    std::vector<double> x, y;
+    void resize(size_t n);
+    size_t size() const;
+    std::vector<Point> toPoints() const;
+};
+
+enum Distribution {
+    DIST_UNIFORM,           //uniform over the box
+    DIST_CLUSTERED,         //gaussian blobs around random centers
+    DIST_POISSON_DISK,      //no two points closer than a fixed radius
+    DIST_JITTERED_GRID,     //one point per grid cell, randomly offset inside it
+    DIST_COCIRCULAR,        //all points exactly on one circle, see generateCocircular()
+    DIST_COLLINEAR          //integer points on a few horizontal and vertical lines
+};
+
+//Fills out with numPoints points of the given distribution inside
+//[0, width) x [0, height). The same seed always gives the same points,
+//whatever numThreads is (numThreads <= 0 means one per core).
+//DIST_POISSON_DISK places as many points as fit its radius, up to
+//numPoints, so it may return slightly fewer.
+void generatePoints(PointBuffer& out, Distribution dist, size_t numPoints, double width, double height, uint64_t seed, int numThreads);
+std::vector<Point> generatePoints(Distribution dist, size_t numPoints, double width, double height, uint64_t seed);
+
+#endif
@@ -72,6 +72,10 @@ class Triangle {
     friend std::ostream& operator<<(std::ostream& os, Triangle p);
 };
 
+//Center of the circle through a, b and c, computed directly rather than
+//through Line intersections so vertical edges need no special casing
+Point circumcenter(const Point& a, const Point& b, const Point& c);
+
 class Cell {
     public:
     Point site;
@@ -2,17 +2,31 @@
 #define MAIN_H
 
 #include "geom.hpp"
+#include "batch.hpp"
+#include "predicates.hpp"
+#include "generate.hpp"
+#include "analytics.hpp"
+#include "mesh.hpp"
+#include "tiled.hpp"
+#include "smalldelauney.hpp"
 
 void createWindow(int width, int height, std::vector<Point> sites, std::vector<Triangle> triangles, std::vector<Cell> voronoi);
 std::vector<Point> randomPoints(int width, int height, int num_points);
+std::vector<Point> randomPoints(int width, int height, int num_points, uint64_t seed);
 void DrawTriangle(SDL_Renderer* renderer, Triangle tri);
 void DrawCircle(SDL_Renderer * renderer, int centreX, int centreY, int radius);
 void DrawCell(SDL_Renderer* renderer, Cell cell);
 std::vector<Triangle> delauney(std::vector<Point> sites);
+void delauney(const std::vector<Point>& input, DelauneyScratch& scratch, std::vector<Triangle>& out);
+template <typename T> void delauneyWith(const std::vector<Point>& input, DelauneyScratch& scratch, std::vector<Triangle>& out);
 bool verifyDelauney(std::vector<Point> sites, std::vector<Triangle> triangles);
 template <class T> void printVector(std::vector<T> &vec);
 template <typename T> bool vectorSetInsert(std::vector<T>& vec, T elem);
 bool rigorDelauney(int rangeX, int rangeY, int numPoints, int numRuns, bool verbose);
+bool rigorMesh(int rangeX, int rangeY, int numPoints, int numRuns, bool verbose);
+bool rigorTiled(int rangeX, int rangeY, int numPoints, int numRuns, const std::string& workDir, bool verbose);
+bool rigorSmall(int rangeX, int rangeY, int numRuns, bool verbose);
+bool rigorAnalytics(int rangeX, int rangeY, int numPoints, int numRuns, bool verbose);
 std::vector<Cell> delauneyToVoronoi(std::vector<Point> sites, std::vector<Triangle> triangles);
 void presentWindow();
 
@@ -0,0 +1,86 @@
+#ifndef MESH_H
+#define MESH_H
+
+#include <atomic>
+#include <deque>
+#include <vector>
+
+#include "geom.hpp"
+
+#define MESH_NO_OWNER -1
+
+//What became of each point passed to Mesh::insertBatch()
+#define MESH_SITE_SKIPPED 0     //outside the bounds or a duplicate
+#define MESH_SITE_INSERTED 1
+#define MESH_SITE_LOST 2        //its cavity wasn't star shaped, see Mesh::insertSite()
+
+//One triangle of a Mesh. Fields are atomics so a thread walking the mesh
+//can read a triangle another thread is rewriting without undefined
+//behaviour; it may see stale values, which the walk tolerates.
+class MeshTriangle {
+    public:
+    std::atomic<int> v[3];      //vertex indices, counterclockwise
+    std::atomic<int> n[3];      //n[i] is the neighbor across the edge opposite v[i], -1 if none
+    std::atomic<int> owner;     //worker currently editing this triangle or MESH_NO_OWNER
+    MeshTriangle();
+};
+
+//Per-worker working storage for Mesh::insertBatch()
+class MeshScratch {
+    public:
+    std::vector<int> cavity;    //triangles whose circumcircle holds the new site
+    std::vector<int> owned;     //every triangle claimed so far
+    std::vector<int> boundary;  //4 ints per cavity edge: a, b, outer triangle, cavity triangle
+    std::vector<int> slots;     //where the new triangles go
+    int hint;                   //where the next point location walk starts
+    MeshScratch();
+};
+
+//A live triangulation that many threads can insert into at once. Each
+//insertion claims the triangles it is about to change (its Bowyer-Watson
+//cavity plus the ring around it) by compare-and-swapping their owner tag.
+//If a triangle is already owned by someone else, everything claimed is
+//released and the insertion starts over. Insertions with disjoint cavities
+//never wait on each other and there is no global lock.
+class Mesh {
+    public:
+    //Sites must fall inside [minX, maxX] x [minY, maxY]
+    Mesh(double minX, double minY, double maxX, double maxY);
+
+    //Inserts points using numThreads workers (<= 0 means one per core) and
+    //returns how many were added. Points outside the bounds and duplicates
+    //of existing sites are skipped. Only one insertBatch() may run at a time;
+    //the concurrency is inside it.
+    int insertBatch(const std::vector<Point>& points, int numThreads);
+
+    //Triangles between real sites, i.e. without the enclosing supertriangle
+    std::vector<Triangle> triangles() const;
+    //Every triangle, including those with a supertriangle corner, as three
+    //vertex indices each, counterclockwise. Indices below SUPER_CORNERS are
+    //the symbolic corners, which have no position; the rest go to vertex().
+    std::vector<int> triangleVertices() const;
+    const Point& vertex(int i) const;
+    std::vector<Point> sites() const;
+
+    //Checks every triangle is counterclockwise and every edge is locally
+    //Delaunay, which together mean the mesh is Delaunay, and that the
+    //triangles between real sites number 2n - 2 - h (see
+    //expectedTriangleCount()) for every point that was in bounds and not a
+    //duplicate, so no site was lost and none are missing along the hull.
+    //O(n log n), unlike verifyDelauney().
+    bool verify() const;
+
+    private:
+    double minX, minY, maxX, maxY;
+    std::vector<Point> vertices;        //first SUPER_CORNERS are the supertriangle
+    std::vector<char> status;           //MESH_SITE_* per vertex, char so workers can set entries concurrently
+    std::deque<MeshTriangle> tris;      //deque so growing never moves a triangle
+    std::atomic<int> numTris;
+
+    int locate(int site, int start) const;
+    bool claim(int t, int worker, MeshScratch& scratch);
+    void release(MeshScratch& scratch);
+    int insertSite(int site, int worker, MeshScratch& scratch);
+};
+
+#endif
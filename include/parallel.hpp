@@ -0,0 +1,56 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+//Number of worker threads to use when the caller doesn't care
+inline int defaultThreadCount() {
+    unsigned int hw = std::thread::hardware_concurrency();
+    return hw == 0 ? 1 : (int) hw;
+}
+
+//Calls fn(worker, i) for every i in [0, count) using numThreads workers.
+//Workers pull indices off a shared atomic counter, so a worker that finishes
+//its item early simply grabs the next one instead of sitting idle while a
+//slow item is still running elsewhere. worker is in [0, numThreads) and can
+//be used to index per-thread scratch storage.
+template <typename F>
+void parallelFor(size_t count, int numThreads, F fn) {
+    if(numThreads < 1) numThreads = 1;
+    if((size_t) numThreads > count) numThreads = (int) count;
+    if(numThreads <= 1) {
+        for(size_t i = 0; i < count; i++) fn(0, i);
+        return;
+    }
+
+    std::atomic<size_t> next(0);
+    auto work = [&](int worker) {
+        for(size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1)) {
+            fn(worker, i);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for(int t = 1; t < numThreads; t++) {
+        threads.push_back(std::thread(work, t));
+    }
+    work(0);    //Calling thread does its share too
+    for(std::thread& th : threads) th.join();
+}
+
+//Same as parallelFor, but for cheap per-index work: indices are handed out
+//chunkSize at a time and fn(worker, i) is called for each one
+template <typename F>
+void parallelForChunked(size_t count, size_t chunkSize, int numThreads, F fn) {
+    size_t numChunks = (count + chunkSize - 1) / chunkSize;
+    parallelFor(numChunks, numThreads, [&](int worker, size_t chunk) {
+        size_t end = chunk * chunkSize + chunkSize;
+        if(end > count) end = count;
+        for(size_t i = chunk * chunkSize; i < end; i++) fn(worker, i);
+    });
+}
+
+#endif
@@ -0,0 +1,189 @@
+#ifndef PREDICATES_H
+#define PREDICATES_H
+
+#include <algorithm>
+#include <cstdint>
+
+#include "geom.hpp"
+
+//Grid coordinates must stay within +-GRID_COORD_LIMIT for the integer
+//predicates below to be exact. Differences then fit in 30 bits, 2x2
+//determinants in int64 and the lifted 3x3 in-circle determinant in int128.
+#define GRID_COORD_LIMIT (1 << 28)
+
+//Bare coordinate pair used by the predicates. Point stays the double type
+//the rest of the code passes around; these are what it gets narrowed or
+//rounded into before an orientation or in-circle test.
+template <typename T>
+class BasicPoint {
+    public:
+    T x, y;
+    BasicPoint() : x(0), y(0) {}
+    BasicPoint(T x, T y) : x(x), y(y) {}
+    explicit BasicPoint(const Point& p) : x((T) p.x), y((T) p.y) {}
+};
+
+typedef BasicPoint<float> FloatPoint;
+typedef BasicPoint<double> DoublePoint;
+typedef BasicPoint<int32_t> GridPoint;
+
+//Wide is what coordinate differences and 2x2 determinants are computed in,
+//Wider is what the in-circle determinant is accumulated in. Only int32 goes
+//through the generic predicates below; float and double have their own.
+template <typename T> struct CoordTraits;
+
+template <> struct CoordTraits<int32_t> {
+    typedef int64_t Wide;
+    typedef __int128 Wider;
+    static const bool exact = true;
+};
+
+template <typename W>
+inline int signOf(W v) {
+    return (v > 0) - (v < 0);
+}
+
+//1 if a, b, c wind counterclockwise, -1 if clockwise, 0 if collinear
+template <typename T>
+int orient2d(BasicPoint<T> a, BasicPoint<T> b, BasicPoint<T> c) {
+    typedef typename CoordTraits<T>::Wide W;
+    W det = ((W) b.x - a.x) * ((W) c.y - a.y) - ((W) b.y - a.y) * ((W) c.x - a.x);
+    return signOf(det);
+}
+
+//1 if d is strictly inside the circumcircle of a, b, c, 0 if it is on it
+//and -1 if it is outside. Works for either winding of a, b, c; a degenerate
+//(collinear) triangle always gives 0.
+template <typename T>
+int inCircle(BasicPoint<T> a, BasicPoint<T> b, BasicPoint<T> c, BasicPoint<T> d) {
+    typedef typename CoordTraits<T>::Wide W;
+    typedef typename CoordTraits<T>::Wider X;
+
+    W adx = (W) a.x - d.x, ady = (W) a.y - d.y;
+    W bdx = (W) b.x - d.x, bdy = (W) b.y - d.y;
+    W cdx = (W) c.x - d.x, cdy = (W) c.y - d.y;
+
+    X alift = (X) (adx * adx + ady * ady);
+    X blift = (X) (bdx * bdx + bdy * bdy);
+    X clift = (X) (cdx * cdx + cdy * cdy);
+
+    X det = alift * (X) (bdx * cdy - cdx * bdy)
+          + blift * (X) (cdx * ady - adx * cdy)
+          + clift * (X) (adx * bdy - bdx * ady);
+
+    return signOf(det) * orient2d(a, b, c);
+}
+
+//Doubles are evaluated in double with a bound on the rounding error and,
+//only when the result is too close to zero to trust, again in exact
+//arithmetic, so they are exact too. Floats widen to double without
+//rounding and go through the same.
+template <> int orient2d<double>(DoublePoint a, DoublePoint b, DoublePoint c);
+template <> int inCircle<double>(DoublePoint a, DoublePoint b, DoublePoint c, DoublePoint d);
+template <> int orient2d<float>(FloatPoint a, FloatPoint b, FloatPoint c);
+template <> int inCircle<float>(FloatPoint a, FloatPoint b, FloatPoint c, FloatPoint d);
+
+//True if p has integer coordinates within GRID_COORD_LIMIT, in which case
+//it can go through the exact int32 predicates
+bool isGridPoint(const Point& p);
+
+//Point versions of the above. These use the integer predicates when every
+//argument is a grid point and the double ones otherwise.
+int orient2d(const Point& a, const Point& b, const Point& c);
+int inCircle(const Point& a, const Point& b, const Point& c, const Point& d);
+
+//Vertex arrays passed to the symbolic predicates below start with the
+//three corners of an enclosing supertriangle. Their coordinates are never
+//read.
+#define SUPER_CORNERS 3
+
+//The supertriangle corners stand for the points (-M, -M^2), (M, -M^3) and
+//(-M, M^4) in the limit of M going to infinity. Any orientation or
+//in-circle test involving them is then a polynomial in M, and its sign is
+//the sign of the leading term. Those leading terms were worked out once and
+//reduce to the tables below, which compare coordinates of the real points
+//involved. The result is exact for some finite M, so the predicates stay
+//consistent with each other. A corner is never inside the circumcircle of
+//real sites, so the triangles between real sites are exactly their own
+//Delaunay triangulation, hull included.
+
+//sx * sign(a.x - b.x), or sy * sign(a.y - b.y) if the x coordinates tie
+template <typename P>
+int lexSign(const P& a, const P& b, int sx, int sy) {
+    if(a.x != b.x) return a.x > b.x ? sx : -sx;
+    return a.y > b.y ? sy : (a.y < b.y ? -sy : 0);
+}
+
+//orient2d() of v[a], v[b], v[c], where indices below SUPER_CORNERS are the
+//symbolic supertriangle corners
+template <typename P>
+int orient2dSymbolic(const P* v, int a, int b, int c) {
+    int corners = (a < SUPER_CORNERS) + (b < SUPER_CORNERS) + (c < SUPER_CORNERS);
+    if(corners == 0) return orient2d(v[a], v[b], v[c]);
+    if(corners == 3) return b == (a + 1) % 3 ? 1 : -1;
+
+    //Rotating keeps the sign; rotate the corners to the end
+    while(c >= SUPER_CORNERS || (corners == 2 && b >= SUPER_CORNERS)) {
+        int t = a;
+        a = b;
+        b = c;
+        c = t;
+    }
+    //The corners are counterclockwise in index order around every site
+    if(corners == 2) return c == (b + 1) % 3 ? 1 : -1;
+
+    static const int sign[3][2] = {{1, -1}, {1, 1}, {-1, -1}};
+    return lexSign(v[a], v[b], sign[c][0], sign[c][1]);
+}
+
+//inCircle() of v[a], v[b], v[c], v[d], where indices below SUPER_CORNERS
+//are the symbolic supertriangle corners
+template <typename P>
+int inCircleSymbolic(const P* v, int a, int b, int c, int d) {
+    //The answer doesn't depend on the triangle's order; sort its corners last
+    if(a < b) std::swap(a, b);
+    if(b < c) std::swap(b, c);
+    if(a < b) std::swap(a, b);
+    int corners = (a < SUPER_CORNERS) + (b < SUPER_CORNERS) + (c < SUPER_CORNERS);
+
+    if(d < SUPER_CORNERS) {
+        if(d == a || d == b || d == c) return 0;
+        if(corners == 0) return orient2d(v[a], v[b], v[c]) == 0 ? 0 : -1;
+        if(corners == 2) return -1;
+
+        //Triangle a, b, corner c against corner d: one entry for a and b
+        //differing in x, one for a tie in x
+        static const int inside[3][3][2] = {
+            {{0, 0}, {-1, -1}, {-1, -1}},
+            {{1, -1}, {0, 0}, {-1, -1}},
+            {{-1, 1}, {-1, -1}, {0, 0}}
+        };
+        if(v[a].x == v[b].x && v[a].y == v[b].y) return 0;
+        return inside[c][d][v[a].x == v[b].x];
+    }
+
+    if(corners == 0) return inCircle(v[a], v[b], v[c], v[d]);
+    if(corners == 3) return 1;
+
+    if(corners == 1) {
+        //The circle becomes the half plane on the corner's side of a-b
+        if(v[a].x == v[b].x && v[a].y == v[b].y) return 0;
+        int side = orient2d(v[a], v[b], v[d]);
+        if(side != 0) return side == orient2dSymbolic(v, a, b, c) ? 1 : -1;
+
+        //On the line itself only the open segment a-b is inside
+        const P& p = v[d];
+        if((p.x == v[a].x && p.y == v[a].y) || (p.x == v[b].x && p.y == v[b].y)) return 0;
+        bool between = std::min(v[a].x, v[b].x) <= p.x && p.x <= std::max(v[a].x, v[b].x)
+                        && std::min(v[a].y, v[b].y) <= p.y && p.y <= std::max(v[a].y, v[b].y);
+        return between ? 1 : -1;
+    }
+
+    //Two corners: the circle becomes a half plane bounded by a vertical
+    //line through a, indexed by the corner that isn't in the triangle
+    static const int sign[3][2] = {{-1, -1}, {1, -1}, {-1, 1}};
+    int missing = 3 - b - c;
+    return lexSign(v[a], v[d], sign[missing][0], sign[missing][1]);
+}
+
+#endif
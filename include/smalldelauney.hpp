@@ -0,0 +1,252 @@
+#ifndef SMALLDELAUNEY_H
+#define SMALLDELAUNEY_H
+
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "geom.hpp"
+#include "predicates.hpp"
+
+//Delaunay triangulation of at most N sites with every array sized at
+//compile time, so a SmallDelauney on the stack never touches the heap.
+//Meant for tiny neighborhoods where delauney()'s setup and allocations
+//cost more than the triangulation itself.
+//
+//Sites are inserted one at a time into a supertriangle with symbolic
+//corners (see orient2dSymbolic()), so no hull triangle is lost to a corner
+//being too close: the triangle holding the site is split (or the two
+//sharing the edge it lands on) and edges are flipped until they are
+//locally Delaunay again.
+//
+//T is the coordinate type the sites are stored and tested in. int32_t
+//takes only grid points (see isGridPoint()) and is the faster of the two;
+//double takes anything. Both are exact.
+template <int N, typename T = double>
+class SmallDelauney {
+    static_assert(N >= 3 && N <= 32, "SmallDelauney is for 3 to 32 sites");
+    static_assert(std::is_same<T, int32_t>::value || std::is_same<T, double>::value, "SmallDelauney coordinates are int32_t or double");
+
+    public:
+    static constexpr int MAX_VERTS = N + SUPER_CORNERS;  //sites plus supertriangle
+    static constexpr int MAX_TRIS = 2 * MAX_VERTS - 5;  //Euler bound for a triangulated triangle
+    //The flip stack only ever holds distinct triangles around the new
+    //site, so no more than its degree, which is below MAX_VERTS
+    static constexpr int MAX_STACK = MAX_VERTS;
+
+    SmallDelauney() : numVerts(0), numTris(0), numOut(0) {}
+
+    //Triangulates sites[0..count). Duplicate sites are ignored. Returns
+    //false, with no triangles, if count is more than N, if T is int32_t and
+    //a site isn't a grid point, or if the mesh came out inconsistent, which
+    //the exact predicates should make impossible.
+    bool triangulate(const Point* sites, int count) {
+        numOut = 0;
+        if(count > N) return false;
+        if(count <= 0) return true;
+
+        //The corners need no coordinates; theirs are placeholders
+        for(int i = 0; i < SUPER_CORNERS; i++) verts[i] = BasicPoint<T>();
+        for(int i = 0; i < count; i++) {
+            if(!accepts(sites[i])) return false;
+            verts[SUPER_CORNERS + i] = BasicPoint<T>(sites[i]);
+        }
+        numVerts = SUPER_CORNERS + count;
+
+        setTri(0, 0, 1, 2, -1, -1, -1);
+        numTris = 1;
+        for(int p = SUPER_CORNERS; p < numVerts; p++) {
+            if(!insert(p)) return false;
+        }
+
+        for(int t = 0; t < numTris; t++) {
+            if(tv[t][0] >= SUPER_CORNERS && tv[t][1] >= SUPER_CORNERS && tv[t][2] >= SUPER_CORNERS) out[numOut++] = t;
+        }
+        return true;
+    }
+
+    int triangleCount() const { return numOut; }
+
+    //Corners of triangle i as indices into the sites passed to triangulate()
+    void corners(int i, int& a, int& b, int& c) const {
+        a = tv[out[i]][0] - SUPER_CORNERS;
+        b = tv[out[i]][1] - SUPER_CORNERS;
+        c = tv[out[i]][2] - SUPER_CORNERS;
+    }
+
+    Triangle triangle(int i) const {
+        return Triangle(site(tv[out[i]][0]), site(tv[out[i]][1]), site(tv[out[i]][2]));
+    }
+
+    //Copy of the result in the form delauney() returns, e.g. to pass on to
+    //delauneyToVoronoi(). This one does allocate.
+    std::vector<Triangle> triangles() const {
+        std::vector<Triangle> list;
+        list.reserve(numOut);
+        for(int i = 0; i < numOut; i++) list.push_back(triangle(i));
+        return list;
+    }
+
+    private:
+    BasicPoint<T> verts[MAX_VERTS];
+    int tv[MAX_TRIS][3];    //corners, counterclockwise
+    int tn[MAX_TRIS][3];    //tn[t][k] is the neighbor across the edge opposite tv[t][k]
+    int stack[MAX_STACK];
+    int out[MAX_TRIS];
+    int numVerts, numTris, numOut;
+
+    static bool accepts(const Point& p) {
+        return std::is_same<T, double>::value || isGridPoint(p);
+    }
+
+    Point site(int v) const {
+        return Point((double) verts[v].x, (double) verts[v].y);
+    }
+
+    void setTri(int t, int a, int b, int c, int na, int nb, int nc) {
+        tv[t][0] = a; tv[t][1] = b; tv[t][2] = c;
+        tn[t][0] = na; tn[t][1] = nb; tn[t][2] = nc;
+    }
+
+    void replaceNeighbor(int t, int from, int to) {
+        if(t < 0) return;
+        for(int k = 0; k < 3; k++) {
+            if(tn[t][k] == from) tn[t][k] = to;
+        }
+    }
+
+    //Which side of t the edge shared with neighbor nb is on, or -1 if the
+    //links don't agree
+    int sideOf(int nb, int t) const {
+        for(int k = 0; k < 3; k++) {
+            if(tn[nb][k] == t) return k;
+        }
+        return -1;
+    }
+
+    int orient(int a, int b, int c) const {
+        return orient2dSymbolic(verts, a, b, c);
+    }
+
+    //Orientation of p against each edge of t; true if none is negative
+    bool holds(int t, int p, int o[3]) const {
+        o[0] = orient(tv[t][1], tv[t][2], p);
+        o[1] = orient(tv[t][2], tv[t][0], p);
+        o[2] = orient(tv[t][0], tv[t][1], p);
+        return o[0] >= 0 && o[1] >= 0 && o[2] >= 0;
+    }
+
+    //Triangle holding p, or -1. Walks from the newest triangle, which is
+    //next to the last site; on a Delaunay triangulation the walk never
+    //revisits a triangle, so it takes fewer than numTris steps. Should it
+    //run longer or off the mesh anyway, every triangle is tried in turn.
+    int locate(int p, int o[3]) const {
+        int t = numTris - 1, from = -1;
+        for(int steps = 0; steps < numTris && t >= 0; steps++) {
+            //The edge just crossed has p strictly on this side
+            int k = 0;
+            for(; k < 3; k++) {
+                if(tn[t][k] == from && from >= 0) continue;
+                if(orient(tv[t][(k + 1) % 3], tv[t][(k + 2) % 3], p) < 0) break;
+            }
+            if(k == 3) {
+                holds(t, p, o);
+                return t;
+            }
+            from = t;
+            t = tn[t][k];
+        }
+        for(t = 0; t < numTris; t++) {
+            if(holds(t, p, o)) return t;
+        }
+        return -1;
+    }
+
+    //Inserts site p; false if the mesh turned out inconsistent
+    bool insert(int p) {
+        int o[3];
+        int t = locate(p, o);
+        if(t < 0) return false;
+
+        //Only an edge between two sites can have p on it, so p being on
+        //two edges means it is a duplicate of the site they share
+        int zeros = (o[0] == 0) + (o[1] == 0) + (o[2] == 0);
+        if(zeros > 1) return true;
+        if(numTris + 2 > MAX_TRIS) return false;
+
+        int top = 0;
+        if(zeros == 0) {
+            //Split t into three around p
+            int a = tv[t][0], b = tv[t][1], c = tv[t][2];
+            int n0 = tn[t][0], n1 = tn[t][1], n2 = tn[t][2];
+            int t1 = numTris++, t2 = numTris++;
+            setTri(t, p, b, c, n0, t1, t2);
+            setTri(t1, p, c, a, n1, t2, t);
+            setTri(t2, p, a, b, n2, t, t1);
+            replaceNeighbor(n1, t, t1);
+            replaceNeighbor(n2, t, t2);
+            stack[top++] = t;
+            stack[top++] = t1;
+            stack[top++] = t2;
+        }
+        else {
+            //p is on the edge opposite corner k; split t and its neighbor
+            //across that edge into two each. An edge between two sites is
+            //never on the outside, so the neighbor is there.
+            int k = o[0] == 0 ? 0 : (o[1] == 0 ? 1 : 2);
+            int c = tv[t][k], a = tv[t][(k + 1) % 3], b = tv[t][(k + 2) % 3];
+            int tA = tn[t][(k + 1) % 3], tB = tn[t][(k + 2) % 3];
+            int nb = tn[t][k];
+            int j = nb >= 0 ? sideOf(nb, t) : -1;
+            if(j < 0) return false;
+            int dv = tv[nb][j];
+            int nB = tn[nb][(j + 1) % 3], nA = tn[nb][(j + 2) % 3];
+
+            int t2 = numTris++, t4 = numTris++;
+            setTri(t, p, b, c, tA, t2, t4);
+            setTri(t2, p, c, a, tB, nb, t);
+            setTri(nb, p, a, dv, nB, t4, t2);
+            setTri(t4, p, dv, b, nA, t, nb);
+            replaceNeighbor(tB, t, t2);
+            replaceNeighbor(nA, nb, t4);
+            stack[top++] = t;
+            stack[top++] = t2;
+            stack[top++] = nb;
+            stack[top++] = t4;
+        }
+
+        //Every stacked triangle has p as corner 0; check the edge facing it
+        while(top > 0) {
+            int s = stack[--top];
+            int nb = tn[s][0];
+            if(nb < 0) continue;
+            int j = sideOf(nb, s);
+            if(j < 0) return false;
+            int q = tv[nb][j];
+            int a = tv[s][1], b = tv[s][2];
+            if(inCircleSymbolic(verts, p, a, b, q) <= 0) continue;
+
+            //Flip edge a-b to p-q: s becomes (p, a, q) and nb becomes (p, q, b)
+            if(top + 2 > MAX_STACK) return false;
+            int sA = tn[s][1], sB = tn[s][2];
+            int nbB = tn[nb][(j + 1) % 3], nbA = tn[nb][(j + 2) % 3];
+            setTri(s, p, a, q, nbB, nb, sB);
+            setTri(nb, p, q, b, nbA, sA, s);
+            replaceNeighbor(sA, s, nb);
+            replaceNeighbor(nbB, nb, s);
+            stack[top++] = s;
+            stack[top++] = nb;
+        }
+        return true;
+    }
+};
+
+//Picks the smallest SmallDelauney that fits sites, on int32_t coordinates
+//when they are all grid points, and appends its triangles to out. Past 32
+//sites, or should it fail, delauney() does the work instead.
+void delauneySmall(const std::vector<Point>& sites, std::vector<Triangle>& out);
+
+//Same, returning the triangles like delauney() does
+std::vector<Triangle> delauneySmall(const std::vector<Point>& sites);
+
+#endif
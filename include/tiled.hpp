@@ -0,0 +1,57 @@
+#ifndef TILED_H
+#define TILED_H
+
+#include <string>
+#include <vector>
+
+#include "geom.hpp"
+
+//Axis aligned box, used for tiles, halo regions and circle extents
+class Rect {
+    public:
+    double minX, minY, maxX, maxY;
+    Rect();
+    Rect(double minX, double minY, double maxX, double maxY);
+    bool contains(const Point& p) const;
+    bool contains(const Rect& r) const;
+    Rect unite(const Rect& r) const;
+    Rect intersect(const Rect& r) const;
+};
+
+//What delauneyTiled() did for one tile
+class TileReport {
+    public:
+    int rounds;         //times the tile was sent to a worker
+    size_t maxSites;    //most sites it was sent in one round
+    bool wholeDomain;   //ran out of rounds and was sent every site
+    TileReport();
+};
+
+//Triangulates sites by splitting the bounding box into tilesX x tilesY
+//tiles. Each tile is triangulated by a separate worker that sees the
+//tile's sites, those in a halo around it and those on the global hull.
+//The worker keeps the triangles it owns whose circumcircle lies inside
+//what it was sent; those are certified final, since no site it didn't see
+//can be inside them. With the global hull sent, triangles with a
+//supertriangle corner are always certified. Tiles with uncertified
+//triangles are sent again with exactly the sites inside those
+//circumcircles added, until nothing is left uncertified.
+//
+//Workers talk to the coordinator only through files in workDir. If
+//workerExe is non-empty, each worker is a separate process started as
+//    workerExe --tile-worker <input file> <output file>
+//otherwise workers run on threads inside this process. Returns false if a
+//worker fails.
+bool delauneyTiled(const std::vector<Point>& sites, int tilesX, int tilesY, const std::string& workDir,
+                    const std::string& workerExe, std::vector<Triangle>& out);
+
+//Same, also filling reports with one entry per tile
+bool delauneyTiled(const std::vector<Point>& sites, int tilesX, int tilesY, const std::string& workDir,
+                    const std::string& workerExe, std::vector<Triangle>& out, std::vector<TileReport>& reports);
+
+//Worker side of delauneyTiled(): reads one tile's input file, triangulates
+//it and writes certified and uncertified triangles to outputFile.
+//Returns 0 on success, like a process exit code.
+int runTileWorker(const std::string& inputFile, const std::string& outputFile);
+
+#endif
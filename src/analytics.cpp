@@ -0,0 +1,269 @@
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+#include "analytics.hpp"
+#include "parallel.hpp"
+#include "predicates.hpp"
+
+//Sites handed to one worker at a time by cellStats()
+#define ANALYTICS_CHUNK 1024
+
+static bool lexLess(const Point& a, const Point& b) {
+    return a.x < b.x || (a.x == b.x && a.y < b.y);
+}
+
+//Triangle corners are copies of the sites they were built from, so exact
+//comparison is enough to find them again; no epsilon matching needed
+IndexedTriangulation::IndexedTriangulation(const std::vector<Point>& sites, const std::vector<Triangle>& triangles) : sites(sites) {
+    std::vector<int> order(sites.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](int i, int j) { return lexLess(sites[i], sites[j]); });
+
+    auto find = [&](const Point& p) {
+        auto it = std::lower_bound(order.begin(), order.end(), p, [&](int i, const Point& q) { return lexLess(sites[i], q); });
+        if(it == order.end() || sites[*it].x != p.x || sites[*it].y != p.y) return -1;
+        return *it;
+    };
+
+    corners.reserve(triangles.size() * 3);
+    for(const Triangle& t : triangles) {
+        int a = find(t.a), b = find(t.b), c = find(t.c);
+        if(a < 0 || b < 0 || c < 0) continue;   //not made from these sites
+        corners.push_back(a);
+        corners.push_back(b);
+        corners.push_back(c);
+    }
+}
+
+int IndexedTriangulation::numTriangles() const {
+    return (int) corners.size() / 3;
+}
+
+int SiteGraph::degree(int site) const {
+    return offsets[site + 1] - offsets[site];
+}
+
+//Every triangulation edge once, as (smaller index, larger index)
+static std::vector<std::pair<int, int>> uniqueEdges(const IndexedTriangulation& tri) {
+    std::vector<std::pair<int, int>> edges;
+    edges.reserve(tri.corners.size());
+    for(size_t t = 0; t < tri.corners.size(); t += 3) {
+        for(int k = 0; k < 3; k++) {
+            int a = tri.corners[t + k];
+            int b = tri.corners[t + (k + 1) % 3];
+            edges.push_back(std::make_pair(std::min(a, b), std::max(a, b)));
+        }
+    }
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+    return edges;
+}
+
+SiteGraph buildSiteGraph(const IndexedTriangulation& tri) {
+    std::vector<std::pair<int, int>> edges = uniqueEdges(tri);
+    SiteGraph graph;
+    graph.offsets.assign(tri.sites.size() + 1, 0);
+    for(const auto& e : edges) {
+        graph.offsets[e.first + 1]++;
+        graph.offsets[e.second + 1]++;
+    }
+    for(size_t i = 0; i < tri.sites.size(); i++) {
+        graph.offsets[i + 1] += graph.offsets[i];
+    }
+
+    graph.neighbors.resize(edges.size() * 2);
+    std::vector<int> fill(graph.offsets.begin(), graph.offsets.end() - 1);
+    for(const auto& e : edges) {
+        graph.neighbors[fill[e.first]++] = e.second;
+        graph.neighbors[fill[e.second]++] = e.first;
+    }
+    return graph;
+}
+
+std::vector<CellStats> cellStats(const IndexedTriangulation& tri, int numThreads) {
+    if(numThreads <= 0) numThreads = defaultThreadCount();
+    size_t numSites = tri.sites.size();
+    int numTris = tri.numTriangles();
+
+    std::vector<Point> centers(numTris);
+    parallelForChunked(numTris, ANALYTICS_CHUNK, numThreads, [&](int /*worker*/, size_t t) {
+        centers[t] = circumcenter(tri.sites[tri.corners[3 * t]], tri.sites[tri.corners[3 * t + 1]], tri.sites[tri.corners[3 * t + 2]]);
+    });
+
+    //Triangles around each site, same CSR layout as SiteGraph
+    std::vector<int> triOffsets(numSites + 1, 0);
+    for(int s : tri.corners) triOffsets[s + 1]++;
+    for(size_t i = 0; i < numSites; i++) triOffsets[i + 1] += triOffsets[i];
+    std::vector<int> siteTris(tri.corners.size());
+    std::vector<int> fill(triOffsets.begin(), triOffsets.end() - 1);
+    for(size_t k = 0; k < tri.corners.size(); k++) {
+        siteTris[fill[tri.corners[k]]++] = (int) (k / 3);
+    }
+
+    //An interior site is surrounded by a closed fan, which has as many
+    //triangles as edges. A hull site's fan is open and has one edge extra.
+    SiteGraph graph = buildSiteGraph(tri);
+
+    std::vector<CellStats> stats(numSites);
+    std::vector<std::vector<std::pair<double, Point>>> scratch(numThreads);
+    parallelForChunked(numSites, ANALYTICS_CHUNK, numThreads, [&](int worker, size_t s) {
+        const Point& site = tri.sites[s];
+        CellStats& out = stats[s];
+        out.area = 0;
+        out.centroid = site;
+        int fanSize = triOffsets[s + 1] - triOffsets[s];
+        out.bounded = fanSize > 0 && fanSize == graph.degree((int) s);
+        if(!out.bounded) return;
+
+        //Voronoi cells are convex and contain their site, so sorting the
+        //surrounding circumcenters by angle puts them in polygon order
+        std::vector<std::pair<double, Point>>& ring = scratch[worker];
+        ring.clear();
+        for(int k = triOffsets[s]; k < triOffsets[s + 1]; k++) {
+            Point v(centers[siteTris[k]].x - site.x, centers[siteTris[k]].y - site.y);
+            ring.push_back(std::make_pair(std::atan2(v.y, v.x), v));
+        }
+        std::sort(ring.begin(), ring.end(), [](const std::pair<double, Point>& a, const std::pair<double, Point>& b) { return a.first < b.first; });
+
+        double area2 = 0, cx = 0, cy = 0;
+        for(size_t i = 0; i < ring.size(); i++) {
+            const Point& p = ring[i].second;
+            const Point& q = ring[(i + 1) % ring.size()].second;
+            double cross = p.x * q.y - q.x * p.y;
+            area2 += cross;
+            cx += (p.x + q.x) * cross;
+            cy += (p.y + q.y) * cross;
+        }
+        out.area = area2 / 2;
+        if(area2 != 0) out.centroid = Point(site.x + cx / (3 * area2), site.y + cy / (3 * area2));
+    });
+
+    return stats;
+}
+
+static bool samePoint(const Point& a, const Point& b) {
+    return a.x == b.x && a.y == b.y;
+}
+
+//Sites sorted by lexLess() with duplicates removed
+static std::vector<Point> distinctSites(const std::vector<Point>& sites) {
+    std::vector<Point> points(sites);
+    std::sort(points.begin(), points.end(), lexLess);
+    points.erase(std::unique(points.begin(), points.end(), samePoint), points.end());
+    return points;
+}
+
+//Which of the distinct, sorted points lie on the convex hull's boundary,
+//including along its edges. Andrew's monotone chain, only giving up a
+//point on a clockwise turn so collinear ones stay.
+static std::vector<char> onHull(const std::vector<Point>& points) {
+    int n = (int) points.size();
+    std::vector<char> hull(n, 0);
+    std::vector<int> chain;
+    for(int pass = 0; pass < 2; pass++) {
+        chain.clear();
+        for(int i = 0; i < n; i++) {
+            int p = pass == 0 ? i : n - 1 - i;
+            while(chain.size() >= 2 && orient2d(points[chain[chain.size() - 2]], points[chain.back()], points[p]) < 0) chain.pop_back();
+            chain.push_back(p);
+        }
+        for(int p : chain) hull[p] = 1;
+    }
+    return hull;
+}
+
+std::vector<CellStats> cellStats(const std::vector<Cell>& cells, int numThreads) {
+    if(numThreads <= 0) numThreads = defaultThreadCount();
+    std::vector<CellStats> stats(cells.size());
+
+    //A Voronoi cell is unbounded exactly when its site is on the convex
+    //hull, which the exact orientation test settles without looking at
+    //the cell's edges at all
+    std::vector<Point> sites;
+    for(const Cell& cell : cells) sites.push_back(cell.site);
+    sites = distinctSites(sites);
+    std::vector<char> hull = onHull(sites);
+
+    parallelForChunked(cells.size(), ANALYTICS_CHUNK, numThreads, [&](int /*worker*/, size_t i) {
+        const Cell& cell = cells[i];
+        const Point& s = cell.site;
+        double area = 0, cx = 0, cy = 0;
+        for(const LineSegment& e : cell.edges) {
+            double ax = e.a.x - s.x, ay = e.a.y - s.y;
+            double bx = e.b.x - s.x, by = e.b.y - s.y;
+            double piece = std::fabs(ax * by - bx * ay) / 2;
+            area += piece;
+            cx += piece * (ax + bx) / 3;
+            cy += piece * (ay + by) / 3;
+        }
+        stats[i].area = area;
+        stats[i].centroid = area > 0 ? Point(s.x + cx / area, s.y + cy / area) : s;
+        size_t k = std::lower_bound(sites.begin(), sites.end(), s, lexLess) - sites.begin();
+        stats[i].bounded = area > 0 && !hull[k];
+    });
+
+    return stats;
+}
+
+int expectedTriangleCount(const std::vector<Point>& sites) {
+    std::vector<Point> points = distinctSites(sites);
+    int n = (int) points.size();
+
+    bool collinear = true;
+    for(int i = 2; i < n && collinear; i++) {
+        collinear = orient2d(points[0], points[1], points[i]) == 0;
+    }
+    if(collinear) return 0;
+
+    std::vector<char> hull = onHull(points);
+    return 2 * n - 2 - (int) std::count(hull.begin(), hull.end(), 1);
+}
+
+std::vector<Point> hullSites(const std::vector<Point>& sites) {
+    std::vector<Point> points = distinctSites(sites);
+    std::vector<char> hull = onHull(points);
+    std::vector<Point> out;
+    for(size_t i = 0; i < points.size(); i++) {
+        if(hull[i]) out.push_back(points[i]);
+    }
+    return out;
+}
+
+//Kruskal over the Delaunay edges with a union-find forest
+std::vector<std::pair<int, int>> euclideanMST(const IndexedTriangulation& tri) {
+    std::vector<std::pair<int, int>> edges = uniqueEdges(tri);
+    std::vector<double> lengthSqr(edges.size());
+    for(size_t i = 0; i < edges.size(); i++) {
+        const Point& a = tri.sites[edges[i].first];
+        const Point& b = tri.sites[edges[i].second];
+        lengthSqr[i] = (a.x - b.x) * (a.x - b.x) + (a.y - b.y) * (a.y - b.y);
+    }
+    std::vector<int> order(edges.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](int i, int j) { return lengthSqr[i] < lengthSqr[j]; });
+
+    std::vector<int> parent(tri.sites.size());
+    std::vector<int> size(tri.sites.size(), 1);
+    std::iota(parent.begin(), parent.end(), 0);
+    auto root = [&](int v) {
+        while(parent[v] != v) {
+            parent[v] = parent[parent[v]];
+            v = parent[v];
+        }
+        return v;
+    };
+
+    std::vector<std::pair<int, int>> tree;
+    for(int i : order) {
+        int ra = root(edges[i].first), rb = root(edges[i].second);
+        if(ra == rb) continue;
+        if(size[ra] < size[rb]) std::swap(ra, rb);
+        parent[rb] = ra;
+        size[ra] += size[rb];
+        tree.push_back(edges[i]);
+        if(tree.size() + 1 == tri.sites.size()) break;
+    }
+    return tree;
+}
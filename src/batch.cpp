@@ -0,0 +1,32 @@
+#include <vector>
+
+#include <SDL2/SDL.h>
+
+#include "main.hpp"
+#include "batch.hpp"
+#include "parallel.hpp"
+
+void DelauneyScratch::clear() {
+    sites.clear();
+    gridVerts.clear();
+    floatVerts.clear();
+    doubleVerts.clear();
+    triangles.clear();
+    edges.clear();
+}
+
+std::vector<std::vector<Triangle>> delauneyBatch(const std::vector<std::vector<Point>>& pointSets, int numThreads) {
+    if(numThreads <= 0) numThreads = defaultThreadCount();
+
+    //Every set gets its own slot up front so workers never touch the same
+    //vector and no locking is needed on the output
+    std::vector<std::vector<Triangle>> results(pointSets.size());
+    std::vector<DelauneyScratch> scratch(numThreads);
+
+    parallelFor(pointSets.size(), numThreads, [&](int worker, size_t i) {
+        if(pointSets[i].empty()) return;    //delauney() needs at least one site
+        delauney(pointSets[i], scratch[worker], results[i]);
+    });
+
+    return results;
+}
@@ -0,0 +1,274 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "generate.hpp"
+#include "parallel.hpp"
+
+//Points handed to one worker at a time by the per-point generators
+#define GENERATE_CHUNK 65536
+
+//Dart throws per grid cell for DIST_POISSON_DISK
+#define POISSON_ATTEMPTS 16
+
+void PointBuffer::resize(size_t n) {
+    x.resize(n);
+    y.resize(n);
+}
+
+size_t PointBuffer::size() const {
+    return x.size();
+}
+
+std::vector<Point> PointBuffer::toPoints() const {
+    std::vector<Point> points;
+    points.reserve(x.size());
+    for(size_t i = 0; i < x.size(); i++) {
+        points.push_back(Point(x[i], y[i]));
+    }
+    return points;
+}
+
+//Runs fn(i) for every point index, GENERATE_CHUNK indices at a time
+template <typename F>
+static void forEachPoint(size_t numPoints, int numThreads, F fn) {
+    parallelForChunked(numPoints, GENERATE_CHUNK, numThreads, [&](int /*worker*/, size_t i) { fn(i); });
+}
+
+static void generateUniform(PointBuffer& out, const RandomStream& rng, double width, double height, int numThreads) {
+    forEachPoint(out.size(), numThreads, [&](size_t i) {
+        out.x[i] = rng.uniform(2 * i) * width;
+        out.y[i] = rng.uniform(2 * i + 1) * height;
+    });
+}
+
+static void generateClustered(PointBuffer& out, const RandomStream& rng, double width, double height, int numThreads) {
+    size_t numClusters = std::max((size_t) 1, out.size() / 1000);
+    double sigma = 0.125 * std::min(width, height) / std::sqrt((double) numClusters);
+
+    RandomStream centerRng = rng.split(0);
+    RandomStream pointRng = rng.split(1);
+    std::vector<double> centerX(numClusters), centerY(numClusters);
+    for(size_t k = 0; k < numClusters; k++) {
+        centerX[k] = centerRng.uniform(2 * k) * width;
+        centerY[k] = centerRng.uniform(2 * k + 1) * height;
+    }
+
+    forEachPoint(out.size(), numThreads, [&](size_t i) {
+        size_t k = pointRng.at(3 * i) % numClusters;
+        //Box-Muller, 1 - u keeps the log argument out of zero
+        double radius = sigma * std::sqrt(-2.0 * std::log(1.0 - pointRng.uniform(3 * i + 1)));
+        double angle = 2.0 * M_PI * pointRng.uniform(3 * i + 2);
+        //Wrap around instead of clamping so nothing piles up on the border
+        double x = std::fmod(centerX[k] + radius * std::cos(angle), width);
+        double y = std::fmod(centerY[k] + radius * std::sin(angle), height);
+        out.x[i] = x < 0 ? x + width : x;
+        out.y[i] = y < 0 ? y + height : y;
+    });
+}
+
+static void generateJitteredGrid(PointBuffer& out, const RandomStream& rng, double width, double height, int numThreads) {
+    size_t cols = (size_t) std::ceil(std::sqrt(out.size() * width / height));
+    if(cols == 0) cols = 1;
+    size_t rows = (out.size() + cols - 1) / cols;
+    double cellW = width / cols;
+    double cellH = height / std::max(rows, (size_t) 1);
+
+    forEachPoint(out.size(), numThreads, [&](size_t i) {
+        out.x[i] = ((i % cols) + rng.uniform(2 * i)) * cellW;
+        out.y[i] = ((i / cols) + rng.uniform(2 * i + 1)) * cellH;
+    });
+}
+
+//Points on a circle computed with cos and sin are only near it, so instead
+//they are lattice points on x^2 + y^2 = R^2 for R a product of the primes
+//below, each a sum of two squares. Every way of splitting R^2 into Gaussian
+//integer factors gives one, 4 * 3^k for k primes. Scaling by a power of two
+//and centering on a multiple of it keeps them exact doubles, so the exact
+//predicates see them as truly cocircular. Past the 4 * 3^8 points of the
+//largest circle, points repeat.
+#define COCIRCULAR_PRIMES 8
+
+static void generateCocircular(PointBuffer& out, const RandomStream& rng, double width, double height, int numThreads) {
+    //p = a^2 + b^2 = (a + bi)(a - bi)
+    static const int64_t gaussian[COCIRCULAR_PRIMES][2] = {{1, 2}, {2, 3}, {1, 4}, {2, 5}, {1, 6}, {4, 5}, {2, 7}, {5, 6}};
+
+    //Fewest primes giving as many distinct points as asked for
+    int k = 1;
+    while(k < COCIRCULAR_PRIMES && 4 * std::pow(3.0, k) < out.size()) k++;
+    int64_t radius = 1;
+    for(int j = 0; j < k; j++) radius *= gaussian[j][0] * gaussian[j][0] + gaussian[j][1] * gaussian[j][1];
+
+    //Each prime's factor squared, times its conjugate, or conjugate squared
+    std::vector<int64_t> lx(1, 1), ly(1, 0);
+    for(int j = 0; j < k; j++) {
+        int64_t a = gaussian[j][0], b = gaussian[j][1];
+        int64_t fx[3] = {a * a - b * b, a * a + b * b, a * a - b * b};
+        int64_t fy[3] = {2 * a * b, 0, -2 * a * b};
+        std::vector<int64_t> nx, ny;
+        for(size_t m = 0; m < lx.size(); m++) {
+            for(int e = 0; e < 3; e++) {
+                nx.push_back(lx[m] * fx[e] - ly[m] * fy[e]);
+                ny.push_back(lx[m] * fy[e] + ly[m] * fx[e]);
+            }
+        }
+        lx.swap(nx);
+        ly.swap(ny);
+    }
+    //Times the four units: each further block is the one before turned by
+    //90 degrees
+    size_t base = lx.size();
+    for(size_t m = 0; m < 3 * base; m++) {
+        int64_t x = lx[m], y = ly[m];
+        lx.push_back(-y);
+        ly.push_back(x);
+    }
+
+    //Largest power of two keeping the radius within 0.45 of the box
+    int exponent;
+    std::frexp(0.45 * std::min(width, height) / radius, &exponent);
+    double scale = std::ldexp(1.0, exponent - 1);
+    double cx = std::floor(width / 2 / scale) * scale;
+    double cy = std::floor(height / 2 / scale) * scale;
+
+    //Shuffled so the points come out in random order, each once until the
+    //circle runs out
+    for(size_t m = lx.size() - 1; m > 0; m--) {
+        size_t j = rng.at(m) % (m + 1);
+        std::swap(lx[m], lx[j]);
+        std::swap(ly[m], ly[j]);
+    }
+
+    forEachPoint(out.size(), numThreads, [&](size_t i) {
+        size_t m = i % lx.size();
+        out.x[i] = cx + lx[m] * scale;
+        out.y[i] = cy + ly[m] * scale;
+    });
+}
+
+static void generateCollinear(PointBuffer& out, const RandomStream& rng, double width, double height, int numThreads) {
+    //Every coordinate is a whole number so the points are exactly, not
+    //approximately, collinear
+    size_t numLines = std::min((size_t) 16, std::max((size_t) 2, out.size() / 64));
+    RandomStream lineRng = rng.split(0);
+    RandomStream pointRng = rng.split(1);
+    std::vector<double> linePos(numLines);
+    for(size_t l = 0; l < numLines; l++) {
+        linePos[l] = std::floor(lineRng.uniform(l) * ((l % 2 == 0) ? height : width));
+    }
+
+    forEachPoint(out.size(), numThreads, [&](size_t i) {
+        size_t l = i % numLines;
+        if(l % 2 == 0) {    //horizontal line
+            out.x[i] = std::floor(pointRng.uniform(i) * width);
+            out.y[i] = linePos[l];
+        }
+        else {              //vertical line
+            out.x[i] = linePos[l];
+            out.y[i] = std::floor(pointRng.uniform(i) * height);
+        }
+    });
+}
+
+//Grid based dart throwing. Cells are r / sqrt(2) wide so each holds at most
+//one point and any conflict is within two cells. Cells are visited in nine
+//phases by (x mod 3, y mod 3); cells in the same phase are at least three
+//cells apart, so a phase can be filled in parallel and the outcome only
+//depends on earlier phases, never on thread timing.
+static void generatePoissonDisk(PointBuffer& out, const RandomStream& rng, double width, double height, int numThreads) {
+    size_t target = out.size();
+    double r = std::sqrt(0.65 * width * height / target);
+    double r2 = r * r;
+    double cell = r / std::sqrt(2.0);
+    size_t cols = (size_t) std::ceil(width / cell);
+    size_t rows = (size_t) std::ceil(height / cell);
+
+    const double empty = std::numeric_limits<double>::quiet_NaN();
+    std::vector<double> gridX(cols * rows, empty), gridY(cols * rows, empty);
+
+    auto tryCell = [&](size_t gx, size_t gy) {
+        RandomStream cellRng = rng.split(gy * cols + gx);
+        for(int attempt = 0; attempt < POISSON_ATTEMPTS; attempt++) {
+            double x = (gx + cellRng.uniform(2 * attempt)) * cell;
+            double y = (gy + cellRng.uniform(2 * attempt + 1)) * cell;
+            if(x >= width || y >= height) continue;
+
+            bool clear = true;
+            size_t x0 = gx < 2 ? 0 : gx - 2, x1 = std::min(cols - 1, gx + 2);
+            size_t y0 = gy < 2 ? 0 : gy - 2, y1 = std::min(rows - 1, gy + 2);
+            for(size_t ny = y0; ny <= y1 && clear; ny++) {
+                for(size_t nx = x0; nx <= x1; nx++) {
+                    size_t n = ny * cols + nx;
+                    if(std::isnan(gridX[n])) continue;
+                    double dx = gridX[n] - x, dy = gridY[n] - y;
+                    if(dx * dx + dy * dy < r2) {
+                        clear = false;
+                        break;
+                    }
+                }
+            }
+            if(clear) {
+                gridX[gy * cols + gx] = x;
+                gridY[gy * cols + gx] = y;
+                return;
+            }
+        }
+    };
+
+    for(size_t py = 0; py < 3; py++) {
+        for(size_t px = 0; px < 3; px++) {
+            size_t phaseRows = rows > py ? (rows - py + 2) / 3 : 0;
+            parallelFor(phaseRows, numThreads, [&](int /*worker*/, size_t k) {
+                size_t gy = py + 3 * k;
+                for(size_t gx = px; gx < cols; gx += 3) tryCell(gx, gy);
+            });
+        }
+    }
+
+    std::vector<size_t> filled;
+    for(size_t c = 0; c < gridX.size(); c++) {
+        if(!std::isnan(gridX[c])) filled.push_back(c);
+    }
+
+    //More points may fit than were asked for. Keep a random subset, picked
+    //by a per-cell key from a stream no cell uses, rather than the first
+    //ones in row order, which would leave the top rows empty.
+    if(filled.size() > target) {
+        RandomStream keepRng = rng.split(cols * rows);
+        auto byKey = [&](size_t a, size_t b) { return keepRng.at(a) < keepRng.at(b); };
+        std::nth_element(filled.begin(), filled.begin() + target, filled.end(), byKey);
+        filled.resize(target);
+        std::sort(filled.begin(), filled.end());
+    }
+
+    out.resize(filled.size());
+    for(size_t i = 0; i < filled.size(); i++) {
+        out.x[i] = gridX[filled[i]];
+        out.y[i] = gridY[filled[i]];
+    }
+}
+
+void generatePoints(PointBuffer& out, Distribution dist, size_t numPoints, double width, double height, uint64_t seed, int numThreads) {
+    if(numThreads <= 0) numThreads = defaultThreadCount();
+    out.resize(numPoints);
+    if(numPoints == 0) return;
+
+    //Each distribution draws from its own stream so switching distribution
+    //with the same seed doesn't give correlated points
+    RandomStream rng(seed, (uint64_t) dist);
+    switch(dist) {
+        case DIST_UNIFORM: generateUniform(out, rng, width, height, numThreads); break;
+        case DIST_CLUSTERED: generateClustered(out, rng, width, height, numThreads); break;
+        case DIST_POISSON_DISK: generatePoissonDisk(out, rng, width, height, numThreads); break;
+        case DIST_JITTERED_GRID: generateJitteredGrid(out, rng, width, height, numThreads); break;
+        case DIST_COCIRCULAR: generateCocircular(out, rng, width, height, numThreads); break;
+        case DIST_COLLINEAR: generateCollinear(out, rng, width, height, numThreads); break;
+    }
+}
+
+std::vector<Point> generatePoints(Distribution dist, size_t numPoints, double width, double height, uint64_t seed) {
+    PointBuffer buffer;
+    generatePoints(buffer, dist, numPoints, width, height, seed, 0);
+    return buffer.toPoints();
+}
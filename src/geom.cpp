@@ -8,7 +8,7 @@
 #include "geom.hpp"
 
 bool compareDoubles(double x, double y) {
-    return abs(x - y) <= EPSILON;
+    return std::fabs(x - y) <= EPSILON;
 }
 
 //Point class
@@ -268,6 +268,16 @@ std::ostream& operator<<(std::ostream& os, Triangle p) {
     return os;
 }
 
+Point circumcenter(const Point& a, const Point& b, const Point& c) {
+    //Solved relative to a to keep the numbers small
+    double bx = b.x - a.x, by = b.y - a.y;
+    double cx = c.x - a.x, cy = c.y - a.y;
+    double d = 2 * (bx * cy - by * cx);
+    double b2 = bx * bx + by * by;
+    double c2 = cx * cx + cy * cy;
+    return Point(a.x + (cy * b2 - by * c2) / d, a.y + (bx * c2 - cx * b2) / d);
+}
+
 //Cell class
 Cell::Cell(double x, double y) {
     Point pt(x, y);
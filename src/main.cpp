@@ -9,6 +9,7 @@
 #include <limits>
 #include <ctime>
 #include <chrono>
+#include <string>
 #include <SDL2/SDL.h>
 
 #include "main.hpp"
@@ -21,7 +22,16 @@ SDL_Renderer* renderer;
 
 //main must have this signature for SDL2.0 to work properly
 int main(int arc, char* argv[]) {
+    //Started by delauneyTiled() as a tile worker process
+    if(arc == 4 && std::string(argv[1]) == "--tile-worker") {
+        return runTileWorker(argv[2], argv[3]);
+    }
+
     //rigorDelauney(512, 512, 128, 2500, true);
+    //rigorMesh(512, 512, 2000, 600, false);
+    //rigorTiled(512, 512, 2000, 120, ".", false);
+    //rigorSmall(16, 16, 18000, false);
+    //rigorAnalytics(512, 512, 300, 120, false);
 
     std::vector<Point> sites = randomPoints(512, 512, 256);
     std::cout << "SITES:\n"; 
@@ -57,18 +67,30 @@ void printVector(std::vector<T> &vec) {
     }
 }
 
-//Rigor tests delauney triangulation
+//Rigor tests delauney triangulation: every run must pass verifyDelauney()
+//and have as many triangles as expectedTriangleCount(), so none are
+//missing along the hull
 bool rigorDelauney(int rangeX, int rangeY, int numPoints, int numRuns, bool verbose) {
-    std::cout << "Begin rigor testing Delauney\n";
+    //Run i uses seed baseSeed + i, so a failure can be replayed with
+    //randomPoints(rangeX, rangeY, numPoints, seed)
+    uint64_t baseSeed = (uint64_t) std::time(NULL);
+    std::cout << "Begin rigor testing Delauney, base seed = " << baseSeed << "\n";
     int failedRuns = 0;
+    std::vector<std::vector<Point>> runs;
     for(int i = 0; i < numRuns; i++) {
-        std::vector<Point> sites = randomPoints(rangeX, rangeY, numPoints);
-        std::vector<Triangle> triangles = delauney(sites);
-        if(!verifyDelauney(sites, triangles)) {
-            std::cout << "Run " << i << "failed! Points that failed:" << std::endl;
-            for(Point pt : sites) {
-                std::cout << "\t" << pt << std::endl;
-            }
+        runs.push_back(randomPoints(rangeX, rangeY, numPoints, baseSeed + i));
+    }
+
+    //Every run is independent, so triangulate them all at once
+    std::vector<std::vector<Triangle>> results = delauneyBatch(runs, 0);
+
+    for(int i = 0; i < numRuns; i++) {
+        std::vector<Point>& sites = runs[i];
+        std::vector<Triangle>& triangles = results[i];
+        int expected = expectedTriangleCount(sites);
+        if((int) triangles.size() != expected || !verifyDelauney(sites, triangles)) {
+            std::cout << "Run " << i << " failed! Seed = " << baseSeed + i << ", "
+                        << triangles.size() << " of " << expected << " triangles" << std::endl;
             failedRuns++;
         }
         else {
@@ -87,12 +109,287 @@ bool rigorDelauney(int rangeX, int rangeY, int numPoints, int numRuns, bool verb
     }
 }
 
+//Points for the rigor tests below. Rounding them to whole numbers makes
+//duplicates and exactly collinear or cocircular sites far more common.
+//DIST_COCIRCULAR points are exactly cocircular already and rounding would
+//only move them off the circle, so they are left alone. Runs cycle through
+//the distributions.
+static std::vector<Point> rigorPoints(int rangeX, int rangeY, int numPoints, uint64_t seed, Distribution dist, bool round = true) {
+    std::vector<Point> points = generatePoints(dist, numPoints, rangeX, rangeY, seed);
+    if(!round || dist == DIST_COCIRCULAR) return points;
+    for(Point& p : points) {
+        p.x = std::floor(p.x);
+        p.y = std::floor(p.y);
+    }
+    return points;
+}
+
+//Rigor tests Mesh. Each run inserts its points in two batches of 8
+//workers, whatever the core count, so the claim and retry path runs even
+//on one core. It then checks the mesh with Mesh::verify(), the triangles
+//with verifyDelauney() and their number against expectedTriangleCount().
+//Every other round of distributions keeps the points unrounded. A failure
+//can be replayed with rigorPoints(rangeX, rangeY, numPoints, seed, distribution, rounded).
+bool rigorMesh(int rangeX, int rangeY, int numPoints, int numRuns, bool verbose) {
+    uint64_t baseSeed = (uint64_t) std::time(NULL);
+    std::cout << "Begin rigor testing Mesh, base seed = " << baseSeed << "\n";
+    int failedRuns = 0;
+    for(int i = 0; i < numRuns; i++) {
+        Distribution dist = (Distribution) (i % 6);
+        bool rounded = (i / 6) % 2 == 0;
+        std::vector<Point> sites = rigorPoints(rangeX, rangeY, numPoints, baseSeed + i, dist, rounded);
+        std::vector<Point> first(sites.begin(), sites.begin() + sites.size() / 2);
+        std::vector<Point> second(sites.begin() + sites.size() / 2, sites.end());
+
+        Mesh mesh(0, 0, rangeX, rangeY);
+        mesh.insertBatch(first, 8);
+        mesh.insertBatch(second, 8);
+        std::vector<Triangle> triangles = mesh.triangles();
+        int expected = expectedTriangleCount(sites);
+        if(!mesh.verify() || (int) triangles.size() != expected || !verifyDelauney(sites, triangles)) {
+            std::cout << "Run " << i << " failed! Distribution = " << dist << ", seed = " << baseSeed + i
+                        << (rounded ? ", rounded, " : ", ") << triangles.size() << " of " << expected << " triangles" << std::endl;
+            failedRuns++;
+        }
+        else {
+            if(verbose) {
+                std::cout << "Run " << i << " passed\n";
+            }
+        }
+    }
+    if(!failedRuns) {
+        std::cout << "Rigor testing Mesh: ALL SUCCESS\n";
+        return true;
+    }
+    else {
+        std::cout << "Rigor testing Mesh: " << failedRuns << " runs failed!\n";
+        return false;
+    }
+}
+
+//euclideanMST() against Prim's algorithm over every pair of sites. Any two
+//minimum spanning trees have the same edge lengths, so those are compared.
+static bool rigorCheckMST(const IndexedTriangulation& tri) {
+    const std::vector<Point>& sites = tri.sites;
+    auto lengthSqr = [&](int a, int b) {
+        return (sites[a].x - sites[b].x) * (sites[a].x - sites[b].x) + (sites[a].y - sites[b].y) * (sites[a].y - sites[b].y);
+    };
+
+    std::vector<double> tree;
+    for(const std::pair<int, int>& e : euclideanMST(tri)) tree.push_back(lengthSqr(e.first, e.second));
+
+    std::vector<double> prim, best(sites.size(), std::numeric_limits<double>::infinity());
+    std::vector<char> done(sites.size(), 0);
+    best[0] = 0;
+    for(size_t round = 0; round < sites.size(); round++) {
+        int u = -1;
+        for(int v = 0; v < (int) sites.size(); v++) {
+            if(!done[v] && (u < 0 || best[v] < best[u])) u = v;
+        }
+        done[u] = 1;
+        if(round > 0) prim.push_back(best[u]);
+        for(int v = 0; v < (int) sites.size(); v++) {
+            if(!done[v]) best[v] = std::min(best[v], lengthSqr(u, v));
+        }
+    }
+
+    std::sort(tree.begin(), tree.end());
+    std::sort(prim.begin(), prim.end());
+    return tree == prim;
+}
+
+//buildSiteGraph() against the triangles' own edges, plus Euler's formula:
+//n sites and t triangles have n + t - 1 edges
+static bool rigorCheckGraph(const IndexedTriangulation& tri) {
+    std::set<std::pair<int, int>> edges;
+    for(size_t t = 0; t < tri.corners.size(); t += 3) {
+        for(int k = 0; k < 3; k++) {
+            int a = tri.corners[t + k], b = tri.corners[t + (k + 1) % 3];
+            edges.insert(std::make_pair(a, b));
+            edges.insert(std::make_pair(b, a));
+        }
+    }
+    if(edges.size() != 2 * (tri.sites.size() + tri.numTriangles() - 1)) return false;
+
+    SiteGraph graph = buildSiteGraph(tri);
+    if(graph.neighbors.size() != edges.size()) return false;
+    for(int s = 0; s < (int) tri.sites.size(); s++) {
+        for(int k = graph.offsets[s]; k < graph.offsets[s + 1]; k++) {
+            if(!edges.count(std::make_pair(s, graph.neighbors[k]))) return false;
+        }
+    }
+    return true;
+}
+
+//The two cellStats() overloads against each other: same cells bounded,
+//and the same area and centroid for those
+static bool rigorCheckCells(const std::vector<Point>& sites, const std::vector<Triangle>& triangles, const IndexedTriangulation& tri) {
+    std::vector<CellStats> fromTriangles = cellStats(tri, 0);
+    std::vector<CellStats> fromCells = cellStats(delauneyToVoronoi(sites, triangles), 0);
+    for(size_t i = 0; i < sites.size(); i++) {
+        const CellStats& a = fromTriangles[i];
+        const CellStats& b = fromCells[i];
+        if(a.bounded != b.bounded) return false;
+        if(!a.bounded) continue;
+        double tolerance = 1e-6 * std::max(1.0, a.area);
+        if(std::fabs(a.area - b.area) > tolerance) return false;
+        if(std::fabs(a.centroid.x - b.centroid.x) > 1e-6 || std::fabs(a.centroid.y - b.centroid.y) > 1e-6) return false;
+    }
+    return true;
+}
+
+//Rigor tests the analytics against slow but plain versions of the same.
+//Sites are deduplicated first, since delauneyToVoronoi() would give each
+//copy a cell. delauneyToVoronoi() clips to a 512 x 512 box, so keep
+//rangeX and rangeY within that.
+bool rigorAnalytics(int rangeX, int rangeY, int numPoints, int numRuns, bool verbose) {
+    uint64_t baseSeed = (uint64_t) std::time(NULL);
+    std::cout << "Begin rigor testing analytics, base seed = " << baseSeed << "\n";
+    int failedRuns = 0;
+    for(int i = 0; i < numRuns; i++) {
+        Distribution dist = (Distribution) (i % 6);
+        bool rounded = (i / 6) % 2 == 0;
+        std::vector<Point> sites = rigorPoints(rangeX, rangeY, numPoints, baseSeed + i, dist, rounded);
+        std::sort(sites.begin(), sites.end(), [](const Point& a, const Point& b) { return a.x < b.x || (a.x == b.x && a.y < b.y); });
+        sites.erase(std::unique(sites.begin(), sites.end(), [](const Point& a, const Point& b) { return a.x == b.x && a.y == b.y; }), sites.end());
+
+        std::vector<Triangle> triangles = delauney(sites);
+        IndexedTriangulation tri(sites, triangles);
+        const char* failed = NULL;
+        if(tri.numTriangles() > 0 && !rigorCheckMST(tri)) failed = "EMST";
+        else if(tri.numTriangles() > 0 && !rigorCheckGraph(tri)) failed = "site graph";
+        else if(!rigorCheckCells(sites, triangles, tri)) failed = "cell stats";
+
+        if(failed) {
+            std::cout << "Run " << i << " failed! Distribution = " << dist << ", seed = " << baseSeed + i
+                        << (rounded ? ", rounded, " : ", ") << failed << " mismatch" << std::endl;
+            failedRuns++;
+        }
+        else {
+            if(verbose) {
+                std::cout << "Run " << i << " passed\n";
+            }
+        }
+    }
+    if(!failedRuns) {
+        std::cout << "Rigor testing analytics: ALL SUCCESS\n";
+        return true;
+    }
+    else {
+        std::cout << "Rigor testing analytics: " << failedRuns << " runs failed!\n";
+        return false;
+    }
+}
+
+//Rigor tests delauneyTiled() with in-process workers writing to workDir,
+//cycling through tile grids from 1x1 to 4x3. The tiles' certification
+//leans on Mesh, so the count is checked against expectedTriangleCount(),
+//which works from the hull alone, along with no triangle being reported
+//twice and verifyDelauney(). Unless every site is on the hull, as for
+//DIST_COCIRCULAR, no tile of a split domain may end up sent every site.
+bool rigorTiled(int rangeX, int rangeY, int numPoints, int numRuns, const std::string& workDir, bool verbose) {
+    uint64_t baseSeed = (uint64_t) std::time(NULL);
+    std::cout << "Begin rigor testing tiled, base seed = " << baseSeed << "\n";
+    int failedRuns = 0;
+    for(int i = 0; i < numRuns; i++) {
+        Distribution dist = (Distribution) (i % 6);
+        int tilesX = 1 + i % 4, tilesY = 1 + (i / 4) % 3;
+        std::vector<Point> sites = rigorPoints(rangeX, rangeY, numPoints, baseSeed + i, dist);
+
+        std::vector<Triangle> triangles;
+        std::vector<TileReport> reports;
+        bool ran = delauneyTiled(sites, tilesX, tilesY, workDir, "", triangles, reports);
+
+        bool escalated = false;
+        for(const TileReport& report : reports) {
+            if(report.wholeDomain || (tilesX * tilesY > 1 && report.maxSites >= sites.size())) escalated = true;
+        }
+        if(dist == DIST_COCIRCULAR) escalated = false;
+
+        IndexedTriangulation indexed(sites, triangles);
+        std::set<std::vector<int>> distinct;
+        for(int t = 0; t < indexed.numTriangles(); t++) {
+            std::vector<int> key(indexed.corners.begin() + 3 * t, indexed.corners.begin() + 3 * t + 3);
+            std::sort(key.begin(), key.end());
+            distinct.insert(key);
+        }
+
+        int expected = expectedTriangleCount(sites);
+        if(!ran || escalated || (int) triangles.size() != expected || (int) distinct.size() != expected || !verifyDelauney(sites, triangles)) {
+            std::cout << "Run " << i << " failed! Distribution = " << dist << ", seed = " << baseSeed + i << ", tiles = "
+                        << tilesX << "x" << tilesY << ", " << distinct.size() << " of " << expected << " triangles"
+                        << (escalated ? ", a tile was sent every site" : "") << std::endl;
+            failedRuns++;
+        }
+        else {
+            if(verbose) {
+                std::cout << "Run " << i << " passed\n";
+            }
+        }
+    }
+    if(!failedRuns) {
+        std::cout << "Rigor testing tiled: ALL SUCCESS\n";
+        return true;
+    }
+    else {
+        std::cout << "Rigor testing tiled: " << failedRuns << " runs failed!\n";
+        return false;
+    }
+}
+
+//Rigor tests SmallDelauney<32> on 3 to 32 sites per run. A small range
+//makes duplicate, collinear and cocircular sites common. Every other
+//block of runs leaves the sites unrounded, which the double coordinates
+//take; grid sites go through the int32_t coordinates as well.
+bool rigorSmall(int rangeX, int rangeY, int numRuns, bool verbose) {
+    uint64_t baseSeed = (uint64_t) std::time(NULL);
+    std::cout << "Begin rigor testing SmallDelauney, base seed = " << baseSeed << "\n";
+    int failedRuns = 0;
+    SmallDelauney<32> small;
+    SmallDelauney<32, int32_t> smallGrid;
+    for(int i = 0; i < numRuns; i++) {
+        Distribution dist = (Distribution) (i % 6);
+        int numPoints = 3 + (i / 6) % 30;
+        bool rounded = (i / 180) % 2 == 0;
+        std::vector<Point> sites = rigorPoints(rangeX, rangeY, numPoints, baseSeed + i, dist, rounded);
+
+        bool ran = small.triangulate(sites.data(), (int) sites.size());
+        std::vector<Triangle> triangles = small.triangles();
+        int expected = expectedTriangleCount(sites);
+        bool passed = ran && (int) triangles.size() == expected && verifyDelauney(sites, triangles);
+        bool grid = true;
+        for(const Point& p : sites) grid = grid && isGridPoint(p);
+        if(passed && grid) {
+            ran = smallGrid.triangulate(sites.data(), (int) sites.size());
+            triangles = smallGrid.triangles();
+            passed = ran && (int) triangles.size() == expected && verifyDelauney(sites, triangles);
+        }
+        if(!passed) {
+            std::cout << "Run " << i << " failed! Distribution = " << dist << ", seed = " << baseSeed + i << ", "
+                        << (rounded ? "rounded, " : "") << sites.size() << " sites, " << triangles.size() << " of " << expected << " triangles" << std::endl;
+            failedRuns++;
+        }
+        else {
+            if(verbose) {
+                std::cout << "Run " << i << " passed\n";
+            }
+        }
+    }
+    if(!failedRuns) {
+        std::cout << "Rigor testing SmallDelauney: ALL SUCCESS\n";
+        return true;
+    }
+    else {
+        std::cout << "Rigor testing SmallDelauney: " << failedRuns << " runs failed!\n";
+        return false;
+    }
+}
+
 bool verifyDelauney(std::vector<Point> sites, std::vector<Triangle> triangles) {
     bool soon = true;
     for(Point pt : sites) {
         for(Triangle tri : triangles) {
-            Circle c = tri.circumcircle();
-            if(c.isPointInside2(pt)) {
+            if(inCircle(tri.a, tri.b, tri.c, pt) > 0) {   //circumference exclusive
                 std::cout << "\tViolating " << tri << "\n"; 
                 soon = false;
             }
@@ -164,109 +461,120 @@ std::vector<Cell> delauneyToVoronoi(std::vector<Point> sites, std::vector<Triang
 //Algorithm description taken from http://paulbourke.net/papers/triangulate/
 //The paper has an AMAZING explanation of how this algorithm works
 std::vector<Triangle> delauney(std::vector<Point> sites) {
-    //printf("\nEntered delauney triangulation\n");
-
-    //Init triangle list, which will be final output
+    DelauneyScratch scratch;
     std::vector<Triangle> triangle_list;
+    delauney(sites, scratch, triangle_list);
+    return triangle_list;
+}
 
-    //Sort all points by x coordinate
-    //This improves the runtime from O(n^2) to O(n^1.5) for reasons yet to be understood
-    std::sort(sites.begin(), sites.end());   //Uses operator< for comparision, implemented for Point
-
-    double minX = sites.at(0).x;
-    double maxX = sites.at(sites.size() - 1).x;
-    double minY = sites.at(0).y;
-    double maxY = minY;
-    for(auto it = sites.begin(); it != sites.end(); ++it) {
-        if(it->y < minY) minY = it->y;
-        if(it->y > maxY) maxY = it->y;
+//Same as above, but all working storage comes from scratch so repeated calls
+//don't reallocate. The triangulation is written into out.
+//Integer inputs (like the ones randomPoints() makes) are triangulated in
+//int32 coordinates, anything else in double; both are exact.
+void delauney(const std::vector<Point>& input, DelauneyScratch& scratch, std::vector<Triangle>& out) {
+    bool allGrid = true;
+    for(const Point& p : input) {
+        if(!isGridPoint(p)) {
+            allGrid = false;
+            break;
+        }
     }
 
-    double diffX = maxX - minX;
-    double diffY = maxY - minY;
+    if(allGrid) delauneyWith<int32_t>(input, scratch, out);
+    else delauneyWith<double>(input, scratch, out);
+}
 
-    //These three are the vertices of the supertriangle
-    Point pointA((int) diffX / 2, -2 * diffY);
-    Point pointB(-2 * diffX, diffY);
-    Point pointC(2 * diffX, 2 * diffY);
+//The triangulation itself, with the sites held and every test done in
+//coordinate type T. delauney() picks int32 or double; call
+//delauneyWith<float>() directly to triangulate the sites rounded to float,
+//which halves the working set. Sites that round to the same float are
+//duplicates and only one is kept. The triangles out are always made of the
+//original sites.
+template <typename T>
+void delauneyWith(const std::vector<Point>& input, DelauneyScratch& scratch, std::vector<Triangle>& out) {
+    //printf("\nEntered delauney triangulation\n");
+    scratch.clear();
+    out.clear();
 
-    //Add the vertexes of super triangle to the sites list
-    sites.push_back(pointA);
-    sites.push_back(pointB);
-    sites.push_back(pointC);
+    std::vector<Point>& sites = scratch.sites;
+    sites.assign(input.begin(), input.end());
 
-    //Add supertriangle to triangle list
-    Triangle super_triangle(pointA, pointB, pointC);
-    triangle_list.push_back(super_triangle);
+    //Sort all points by x coordinate
+    //This improves the runtime from O(n^2) to O(n^1.5) for reasons yet to be understood
+    std::sort(sites.begin(), sites.end());   //Uses operator< for comparision, implemented for Point
+
+    //Vertex i + SUPER_CORNERS is sites[i] in type T. The first SUPER_CORNERS
+    //are the supertriangle's, which are symbolic (see orient2dSymbolic()):
+    //they need no coordinates and never displace a hull triangle.
+    std::vector<BasicPoint<T>>& verts = scratch.verts(T());
+    verts.assign(SUPER_CORNERS, BasicPoint<T>());
+    for(const Point& p : sites) verts.push_back(BasicPoint<T>(p));
 
-    Triangle debug_tri(Point(341, 213), Point(214, 5), Point(224, 305));
-    LineSegment cursedLine(Point(214, 5), Point(224, 305));
+    //Init triangle list with the supertriangle, 3 vertex indices per triangle
+    std::vector<int>& triangle_list = scratch.triangles;
+    for(int k = 0; k < SUPER_CORNERS; k++) triangle_list.push_back(k);
 
     //For each point in the sites list
-    for(Point p : sites) {
-        std::vector<LineSegment> edges;
-
-        auto tri_end = triangle_list.end();
-        for(auto it = triangle_list.begin(); it != tri_end; ++it) {
-            Triangle tri = *it;
-            Circle c = tri.circumcircle();
-            if(c.isPointInside(p)) {
-                edges.push_back(tri.sideA);
-                edges.push_back(tri.sideB);
-                edges.push_back(tri.sideC);
-                tri_end = std::remove(triangle_list.begin(), tri_end, tri);
-                it--;
-                if(triangle_list.begin() == tri_end) break;
+    for(int p = SUPER_CORNERS; p < (int) verts.size(); p++) {
+        std::vector<int>& edges = scratch.edges;
+        edges.clear();
+
+        //Take out every triangle whose circumcircle holds p, keeping its
+        //edges in its own counterclockwise direction. Strictly inside, so
+        //the hole left is star shaped around p; a duplicate site is inside
+        //none and adds nothing.
+        size_t kept = 0;
+        for(size_t t = 0; t < triangle_list.size(); t += 3) {
+            const int* v = &triangle_list[t];
+            if(inCircleSymbolic(verts.data(), v[0], v[1], v[2], p) > 0) {
+                for(int k = 0; k < 3; k++) {
+                    edges.push_back(v[k]);
+                    edges.push_back(v[(k + 1) % 3]);
+                }
+            }
+            else {
+                for(int k = 0; k < 3; k++) triangle_list[kept + k] = v[k];
+                kept += 3;
             }
         }
-        triangle_list.erase(tri_end, triangle_list.end());
-
-        //Now we check for any edges that occured more than once, and remove
-        //ALL occurances of any such edge
-        auto end = edges.end();
-        for(auto it = edges.begin(); it != end; ++it) {
-            LineSegment e = *it;
-            auto new_end = std::remove(it + 1, end, e);
-            if(new_end != end) {
-                end = std::remove(edges.begin(), new_end, e);
-                it--;
-                if(edges.begin() == end) break;
+        triangle_list.resize(kept);
+
+        //An edge between two removed triangles shows up once in each
+        //direction; remove both occurrences
+        for(size_t i = 0; i < edges.size(); i += 2) {
+            if(edges[i] < 0) continue;
+            for(size_t j = i + 2; j < edges.size(); j += 2) {
+                if(edges[j] == edges[i + 1] && edges[j + 1] == edges[i]) {
+                    edges[i] = edges[j] = -1;
+                    break;
+                }
             }
         }
-        edges.erase(end, edges.end());
 
-        //Add all triangles formed between point p and the remaining edges in
-        //edges vector
-        for(LineSegment edge : edges) {
-            Triangle new_t(p, edge.a, edge.b);
-            triangle_list.push_back(new_t);
+        //Add all triangles formed between point p and the remaining edges,
+        //which keep p on their left so the new triangles are counterclockwise
+        for(size_t i = 0; i < edges.size(); i += 2) {
+            if(edges[i] < 0) continue;
+            triangle_list.push_back(p);
+            triangle_list.push_back(edges[i]);
+            triangle_list.push_back(edges[i + 1]);
         }
-
     }
 
-    //Before returning, we must remove from the traingle
-    // any triangle list that use vertices from the supertriangle
-    auto tri_end = triangle_list.end();
-    for(auto it = triangle_list.begin(); it != tri_end; ++it) {
-        Triangle t = *it;
-        if(t.pointMatch(pointA) || t.pointMatch(pointB) || t.pointMatch(pointC)) {
-            tri_end = std::remove(triangle_list.begin(), tri_end, t);
-            it--;
-            if(tri_end == triangle_list.begin()) break;
-        }
+    //Leave out any triangle that uses vertices from the supertriangle
+    for(size_t t = 0; t < triangle_list.size(); t += 3) {
+        const int* v = &triangle_list[t];
+        if(v[0] < SUPER_CORNERS || v[1] < SUPER_CORNERS || v[2] < SUPER_CORNERS) continue;
+        out.push_back(Triangle(sites[v[0] - SUPER_CORNERS], sites[v[1] - SUPER_CORNERS], sites[v[2] - SUPER_CORNERS]));
     }
-    triangle_list.erase(tri_end, triangle_list.end());
 
     //std::cout << "Delauney triangulation finished" << std::endl;
-    //remove supertriangle vertices from sites list
-
-    REMOVE_ELEM_FROM_VECTOR(sites, pointA);
-    REMOVE_ELEM_FROM_VECTOR(sites, pointB);
-    REMOVE_ELEM_FROM_VECTOR(sites, pointC);
-
-    return triangle_list;
 }
 
+template void delauneyWith<float>(const std::vector<Point>& input, DelauneyScratch& scratch, std::vector<Triangle>& out);
+template void delauneyWith<double>(const std::vector<Point>& input, DelauneyScratch& scratch, std::vector<Triangle>& out);
+template void delauneyWith<int32_t>(const std::vector<Point>& input, DelauneyScratch& scratch, std::vector<Triangle>& out);
+
 //Deprecate below in favor of macro REMOVE_ELEM_FROM_VECTOR
 //removes all objects equal to elem from list if == is overloaded for T
 template <typename T>
@@ -282,16 +590,21 @@ void removeFromVector(std::vector<T> list, T elem) {
 }
 
 std::vector<Point> randomPoints(int width, int height, int num_points) {
-    std::vector<Point> points;
-    auto seed = std::time(NULL);
+    return randomPoints(width, height, num_points, (uint64_t) std::time(NULL));   //Current systime as seed
+}
 
+//Integer pixel coordinates in [1, width] x [1, height]. The same seed always
+//gives the same points.
+std::vector<Point> randomPoints(int width, int height, int num_points, uint64_t seed) {
     std::cout << "Generating " << num_points << " points in (" << width << ", " << height << ") with seed = " << seed << "\n";
 
-    std::srand(seed);    //Current systime as seed
+    PointBuffer buffer;
+    generatePoints(buffer, DIST_UNIFORM, num_points, width, height, seed, 0);
+
+    std::vector<Point> points;
+    points.reserve(num_points);
     for(int i = 0; i < num_points; i++) {
-        int x_pt = (std::rand() % width) + 1;
-        int y_pt = (std::rand() % height) + 1;
-        Point new_point((double) x_pt, (double) y_pt);
+        Point new_point(std::floor(buffer.x[i]) + 1, std::floor(buffer.y[i]) + 1);
         points.push_back(new_point);
     }
     return points;
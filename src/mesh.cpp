@@ -0,0 +1,341 @@
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "mesh.hpp"
+#include "analytics.hpp"
+#include "parallel.hpp"
+#include "predicates.hpp"
+
+MeshTriangle::MeshTriangle() : owner(MESH_NO_OWNER) {
+    for(int k = 0; k < 3; k++) {
+        v[k].store(0, std::memory_order_relaxed);
+        n[k].store(-1, std::memory_order_relaxed);
+    }
+}
+
+//Points a worker takes at a time from a batch
+#define MESH_CHUNK 256
+
+MeshScratch::MeshScratch() : hint(0) {}
+
+//Position of (x, y) along a Hilbert curve over a 2^16 x 2^16 grid.
+//Consecutive positions are spatially close.
+static uint64_t hilbertIndex(uint32_t x, uint32_t y) {
+    uint64_t d = 0;
+    for(uint32_t s = 1u << 15; s > 0; s >>= 1) {
+        uint32_t rx = (x & s) ? 1 : 0;
+        uint32_t ry = (y & s) ? 1 : 0;
+        d += (uint64_t) s * s * ((3 * rx) ^ ry);
+        if(ry == 0) {
+            if(rx == 1) {
+                x = s - 1 - x;
+                y = s - 1 - y;
+            }
+            std::swap(x, y);
+        }
+    }
+    return d;
+}
+
+static bool contains(const std::vector<int>& list, int x) {
+    return std::find(list.begin(), list.end(), x) != list.end();
+}
+
+Mesh::Mesh(double minX, double minY, double maxX, double maxY) : minX(minX), minY(minY), maxX(maxX), maxY(maxY), numTris(1) {
+    //The supertriangle's corners are symbolic (see orient2dSymbolic()), so
+    //they never displace a triangle between real sites and need no
+    //coordinates; their entries are placeholders
+    vertices.assign(SUPER_CORNERS, Point());
+    status.assign(SUPER_CORNERS, MESH_SITE_SKIPPED);
+
+    tris.emplace_back();
+    for(int k = 0; k < 3; k++) tris[0].v[k].store(k);
+}
+
+//Visibility walk from start towards p. Reads are unsynchronised, so the
+//triangles passed may be mid-rewrite; the caller re-checks the answer once
+//it owns the triangle, and a walk that goes nowhere gives up with -1.
+int Mesh::locate(int site, int start) const {
+    int t = start;
+    int limit = numTris.load(std::memory_order_relaxed) + 64;
+    for(int steps = 0; steps < limit; steps++) {
+        const MeshTriangle& tri = tris[t];
+        int next = t;
+        for(int k = 0; k < 3; k++) {
+            int a = tri.v[(k + 1) % 3].load(std::memory_order_relaxed);
+            int b = tri.v[(k + 2) % 3].load(std::memory_order_relaxed);
+            if(orient2dSymbolic(vertices.data(), a, b, site) < 0) {
+                next = tri.n[k].load(std::memory_order_relaxed);
+                break;
+            }
+        }
+        if(next == t) return t;
+        if(next < 0) return -1;
+        t = next;
+    }
+    return -1;
+}
+
+bool Mesh::claim(int t, int worker, MeshScratch& scratch) {
+    if(contains(scratch.owned, t)) return true;
+    int expected = MESH_NO_OWNER;
+    if(!tris[t].owner.compare_exchange_strong(expected, worker, std::memory_order_acquire)) return false;
+    scratch.owned.push_back(t);
+    return true;
+}
+
+void Mesh::release(MeshScratch& scratch) {
+    for(int t : scratch.owned) {
+        tris[t].owner.store(MESH_NO_OWNER, std::memory_order_release);
+    }
+    scratch.owned.clear();
+}
+
+//Returns one of the MESH_SITE_* values
+int Mesh::insertSite(int site, int worker, MeshScratch& scratch) {
+    const Point& p = vertices[site];
+
+    while(true) {
+        scratch.cavity.clear();
+        scratch.boundary.clear();
+
+        int start = locate(site, scratch.hint);
+        if(start < 0) start = locate(site, 0);
+        if(start < 0 || !claim(start, worker, scratch)) {
+            release(scratch);
+            std::this_thread::yield();
+            continue;
+        }
+
+        //Now that nobody else can change it, make sure the walk was right
+        MeshTriangle& first = tris[start];
+        int fv[3];
+        for(int k = 0; k < 3; k++) fv[k] = first.v[k].load(std::memory_order_relaxed);
+        bool inside = true;
+        for(int k = 0; k < 3 && inside; k++) {
+            inside = orient2dSymbolic(vertices.data(), fv[(k + 1) % 3], fv[(k + 2) % 3], site) >= 0;
+        }
+        if(!inside) {
+            release(scratch);
+            scratch.hint = 0;
+            continue;
+        }
+        for(int k = 0; k < 3; k++) {
+            const Point& q = vertices[fv[k]];
+            if(fv[k] >= SUPER_CORNERS && q.x == p.x && q.y == p.y) {  //duplicate site
+                release(scratch);
+                return MESH_SITE_SKIPPED;
+            }
+        }
+
+        //Grow the cavity outwards. Every neighbor is claimed before it is
+        //looked at, because it either joins the cavity or gets a new
+        //neighbor pointer; both are writes.
+        scratch.cavity.push_back(start);
+        bool conflict = false;
+        for(size_t i = 0; i < scratch.cavity.size() && !conflict; i++) {
+            MeshTriangle& tri = tris[scratch.cavity[i]];
+            for(int k = 0; k < 3; k++) {
+                int nb = tri.n[k].load(std::memory_order_relaxed);
+                if(nb < 0 || contains(scratch.cavity, nb)) continue;
+                bool seen = contains(scratch.owned, nb);
+                if(!claim(nb, worker, scratch)) {
+                    conflict = true;
+                    break;
+                }
+                if(seen) continue;  //already found to be outside
+
+                MeshTriangle& other = tris[nb];
+                int a = other.v[0].load(std::memory_order_relaxed);
+                int b = other.v[1].load(std::memory_order_relaxed);
+                int c = other.v[2].load(std::memory_order_relaxed);
+                if(inCircleSymbolic(vertices.data(), a, b, c, site) > 0) {
+                    scratch.cavity.push_back(nb);
+                }
+            }
+        }
+        if(conflict) {
+            release(scratch);
+            std::this_thread::yield();
+            continue;
+        }
+
+        //Cavity edges that face outwards, as (a, b, outer, cavity triangle)
+        for(int t : scratch.cavity) {
+            MeshTriangle& tri = tris[t];
+            for(int k = 0; k < 3; k++) {
+                int nb = tri.n[k].load(std::memory_order_relaxed);
+                if(nb >= 0 && contains(scratch.cavity, nb)) continue;
+                scratch.boundary.push_back(tri.v[(k + 1) % 3].load(std::memory_order_relaxed));
+                scratch.boundary.push_back(tri.v[(k + 2) % 3].load(std::memory_order_relaxed));
+                scratch.boundary.push_back(nb);
+                scratch.boundary.push_back(t);
+            }
+        }
+
+        //A star shaped cavity of k triangles always has k + 2 outer edges.
+        //With exact predicates the cavity of a site that isn't a duplicate
+        //is always star shaped, so this shouldn't happen; if it does the
+        //site is reported lost, which verify() fails on, rather than the
+        //mesh being corrupted.
+        size_t numNew = scratch.boundary.size() / 4;
+        if(numNew != scratch.cavity.size() + 2) {
+            release(scratch);
+            return MESH_SITE_LOST;
+        }
+
+        //Reuse the cavity's slots and take two fresh ones. The fresh ones are
+        //claimed before anything links to them.
+        scratch.slots.assign(scratch.cavity.begin(), scratch.cavity.end());
+        int fresh = numTris.fetch_add(2);
+        for(int t = fresh; t < fresh + 2; t++) {
+            claim(t, worker, scratch);
+            scratch.slots.push_back(t);
+        }
+
+        for(size_t j = 0; j < numNew; j++) {
+            int a = scratch.boundary[4 * j];
+            int b = scratch.boundary[4 * j + 1];
+            int outer = scratch.boundary[4 * j + 2];
+            int self = scratch.slots[j];
+
+            //New triangle (a, b, site): across a-b is outer, across b-site
+            //is the new triangle starting at b, across site-a is the one
+            //ending at a
+            int across0 = -1, across1 = -1;
+            for(size_t m = 0; m < numNew; m++) {
+                if(scratch.boundary[4 * m] == b) across0 = scratch.slots[m];
+                if(scratch.boundary[4 * m + 1] == a) across1 = scratch.slots[m];
+            }
+
+            MeshTriangle& tri = tris[self];
+            tri.v[0].store(a, std::memory_order_relaxed);
+            tri.v[1].store(b, std::memory_order_relaxed);
+            tri.v[2].store(site, std::memory_order_relaxed);
+            tri.n[0].store(across0, std::memory_order_relaxed);
+            tri.n[1].store(across1, std::memory_order_relaxed);
+            tri.n[2].store(outer, std::memory_order_relaxed);
+
+            //Point outer back at the new triangle. Matched by vertices, not by
+            //the old triangle index, since that slot may have been reused.
+            if(outer >= 0) {
+                MeshTriangle& out = tris[outer];
+                for(int k = 0; k < 3; k++) {
+                    int w = out.v[k].load(std::memory_order_relaxed);
+                    if(w != a && w != b) out.n[k].store(self, std::memory_order_relaxed);
+                }
+            }
+        }
+
+        scratch.hint = scratch.slots[0];
+        release(scratch);
+        return MESH_SITE_INSERTED;
+    }
+}
+
+int Mesh::insertBatch(const std::vector<Point>& points, int numThreads) {
+    if(numThreads <= 0) numThreads = defaultThreadCount();
+
+    //All storage the workers will need is set up front; nothing is allocated
+    //or moved while they run
+    int base = (int) vertices.size();
+    vertices.insert(vertices.end(), points.begin(), points.end());
+    status.resize(vertices.size(), MESH_SITE_SKIPPED);
+    for(size_t i = 0; i < 2 * points.size(); i++) tris.emplace_back();
+
+    //Insert in Hilbert curve order, handing each worker a run of consecutive
+    //points. Each walk then starts next to the previous insertion, and
+    //workers mostly edit different parts of the mesh.
+    double spanX = std::max(maxX - minX, 1e-300), spanY = std::max(maxY - minY, 1e-300);
+    std::vector<std::pair<uint64_t, int>> order(points.size());
+    for(size_t i = 0; i < points.size(); i++) {
+        double fx = std::min(std::max((points[i].x - minX) / spanX, 0.0), 1.0);
+        double fy = std::min(std::max((points[i].y - minY) / spanY, 0.0), 1.0);
+        order[i] = std::make_pair(hilbertIndex((uint32_t) (fx * 65535), (uint32_t) (fy * 65535)), (int) i);
+    }
+    std::sort(order.begin(), order.end());
+
+    std::vector<MeshScratch> scratch(numThreads);
+    std::atomic<int> added(0);
+    parallelForChunked(points.size(), MESH_CHUNK, numThreads, [&](int worker, size_t k) {
+        size_t i = order[k].second;
+        const Point& p = points[i];
+        if(p.x < minX || p.x > maxX || p.y < minY || p.y > maxY) return;
+        status[base + i] = (char) insertSite(base + (int) i, worker, scratch[worker]);
+        if(status[base + i] == MESH_SITE_INSERTED) added.fetch_add(1, std::memory_order_relaxed);
+    });
+
+    //Slots nobody used (skipped points) are dropped again
+    while((int) tris.size() > numTris.load()) tris.pop_back();
+    return added.load();
+}
+
+std::vector<Triangle> Mesh::triangles() const {
+    std::vector<Triangle> out;
+    int count = numTris.load();
+    for(int t = 0; t < count; t++) {
+        int a = tris[t].v[0].load(), b = tris[t].v[1].load(), c = tris[t].v[2].load();
+        if(a < SUPER_CORNERS || b < SUPER_CORNERS || c < SUPER_CORNERS) continue;   //touches the supertriangle
+        out.push_back(Triangle(vertices[a], vertices[b], vertices[c]));
+    }
+    return out;
+}
+
+std::vector<int> Mesh::triangleVertices() const {
+    std::vector<int> out;
+    int count = numTris.load();
+    for(int t = 0; t < count; t++) {
+        for(int k = 0; k < 3; k++) out.push_back(tris[t].v[k].load());
+    }
+    return out;
+}
+
+const Point& Mesh::vertex(int i) const {
+    return vertices[i];
+}
+
+std::vector<Point> Mesh::sites() const {
+    std::vector<Point> out;
+    for(size_t i = SUPER_CORNERS; i < vertices.size(); i++) {
+        if(status[i] == MESH_SITE_INSERTED) out.push_back(vertices[i]);
+    }
+    return out;
+}
+
+bool Mesh::verify() const {
+    int count = numTris.load();
+    int real = 0;
+    for(int t = 0; t < count; t++) {
+        const MeshTriangle& tri = tris[t];
+        int v[3] = {tri.v[0].load(), tri.v[1].load(), tri.v[2].load()};
+        if(orient2dSymbolic(vertices.data(), v[0], v[1], v[2]) <= 0) return false;
+        if(v[0] >= SUPER_CORNERS && v[1] >= SUPER_CORNERS && v[2] >= SUPER_CORNERS) real++;
+
+        for(int k = 0; k < 3; k++) {
+            int nb = tri.n[k].load();
+            if(nb < 0) continue;
+            const MeshTriangle& other = tris[nb];
+            int opposite = -1, backLinks = 0;
+            for(int m = 0; m < 3; m++) {
+                int w = other.v[m].load();
+                if(w != v[(k + 1) % 3] && w != v[(k + 2) % 3]) opposite = w;
+                if(other.n[m].load() == t) backLinks++;
+            }
+            if(opposite < 0 || backLinks != 1) return false;
+            if(inCircleSymbolic(vertices.data(), v[0], v[1], v[2], opposite) > 0) return false;
+        }
+    }
+
+    //Locally Delaunay everywhere only says nothing is wrong with the
+    //triangles there are; the count, over every site that should be in
+    //the mesh, says none are missing
+    std::vector<Point> accepted;
+    for(size_t i = SUPER_CORNERS; i < vertices.size(); i++) {
+        if(status[i] == MESH_SITE_LOST) return false;
+        if(status[i] == MESH_SITE_INSERTED) accepted.push_back(vertices[i]);
+    }
+    return real == expectedTriangleCount(accepted);
+}
@@ -0,0 +1,216 @@
+#include <cmath>
+
+#include "predicates.hpp"
+
+//Exact arithmetic for the double predicates, after Shewchuk, "Adaptive
+//Precision Floating-Point Arithmetic and Fast Robust Geometric Predicates".
+//A number is held as an expansion: doubles whose exact sum is its value,
+//ordered by increasing magnitude and not overlapping, so the sign of the
+//last one is the sign of the whole. Zero components are dropped as they
+//come up, but an expansion always keeps at least one.
+
+//Largest expansions the predicates build: a difference has 2 components,
+//a product of two differences 8, the in-circle lift and cross terms 16 and
+//their products 512
+#define EXPANSION_TERM 512
+
+//Unit roundoff of double, 2^-53
+static const double roundoff = 1.1102230246251565e-16;
+//Error bounds on the plain double evaluations relative to the magnitude of
+//their terms, from the paper
+static const double orientBound = (3.0 + 16.0 * roundoff) * roundoff;
+static const double inCircleBound = (10.0 + 96.0 * roundoff) * roundoff;
+
+//x + y == a + b exactly, with x the rounded sum
+static inline void twoSum(double a, double b, double& x, double& y) {
+    x = a + b;
+    double bv = x - a;
+    double av = x - bv;
+    y = (a - av) + (b - bv);
+}
+
+//x + y == a - b exactly
+static inline void twoDiff(double a, double b, double& x, double& y) {
+    x = a - b;
+    double bv = a - x;
+    double av = x + bv;
+    y = (a - av) + (bv - b);
+}
+
+//x + y == a * b exactly
+static inline void twoProduct(double a, double b, double& x, double& y) {
+    x = a * b;
+    y = std::fma(a, b, -x);
+}
+
+//h = e + f. Returns the length of h, at most elen + flen.
+static int expansionSum(int elen, const double* e, int flen, const double* f, double* h) {
+    //Merge by magnitude, then carry the running sum up through the merged
+    //components, keeping what falls off the bottom of each addition
+    int i = 0, j = 0, n = 0;
+    double q = 0;
+    bool first = true;
+    while(i < elen || j < flen) {
+        double next;
+        if(j >= flen || (i < elen && std::fabs(e[i]) < std::fabs(f[j]))) next = e[i++];
+        else next = f[j++];
+        if(first) {
+            q = next;
+            first = false;
+            continue;
+        }
+        double low;
+        twoSum(q, next, q, low);
+        if(low != 0) h[n++] = low;
+    }
+    if(q != 0 || n == 0) h[n++] = q;
+    return n;
+}
+
+//h = e * b. Returns the length of h, at most 2 * elen.
+static int expansionScale(int elen, const double* e, double b, double* h) {
+    int n = 0;
+    double q, low;
+    twoProduct(e[0], b, q, low);
+    if(low != 0) h[n++] = low;
+    for(int i = 1; i < elen; i++) {
+        double high, sum;
+        twoProduct(e[i], b, high, low);
+        twoSum(q, low, sum, low);
+        if(low != 0) h[n++] = low;
+        twoSum(high, sum, q, low);
+        if(low != 0) h[n++] = low;
+    }
+    if(q != 0 || n == 0) h[n++] = q;
+    return n;
+}
+
+//h = e * f, where h has room for 2 * elen * flen components
+static int expansionProduct(int elen, const double* e, int flen, const double* f, double* h) {
+    double term[2 * EXPANSION_TERM / 16], sum[2 * EXPANSION_TERM];
+    int n = expansionScale(elen, e, f[0], h);
+    for(int j = 1; j < flen; j++) {
+        int termLen = expansionScale(elen, e, f[j], term);
+        n = expansionSum(n, h, termLen, term, sum);
+        for(int k = 0; k < n; k++) h[k] = sum[k];
+    }
+    return n;
+}
+
+static void negate(int elen, double* e) {
+    for(int i = 0; i < elen; i++) e[i] = -e[i];
+}
+
+//a * d - b * c for expansions of 2 components each, at most 16 components
+static int crossExact(const double* a, const double* b, const double* c, const double* d, double* h) {
+    double ad[8], bc[8];
+    int adLen = expansionProduct(2, a, 2, d, ad);
+    int bcLen = expansionProduct(2, b, 2, c, bc);
+    negate(bcLen, bc);
+    return expansionSum(adLen, ad, bcLen, bc, h);
+}
+
+static int orient2dExact(DoublePoint a, DoublePoint b, DoublePoint c) {
+    double acx[2], acy[2], bcx[2], bcy[2], det[16];
+    twoDiff(a.x, c.x, acx[1], acx[0]);
+    twoDiff(a.y, c.y, acy[1], acy[0]);
+    twoDiff(b.x, c.x, bcx[1], bcx[0]);
+    twoDiff(b.y, c.y, bcy[1], bcy[0]);
+    int n = crossExact(acx, acy, bcx, bcy, det);
+    return signOf(det[n - 1]);
+}
+
+//In-circle determinant of a, b, c, d for counterclockwise a, b, c
+static int inCircleExact(DoublePoint a, DoublePoint b, DoublePoint c, DoublePoint d) {
+    double dx[3][2], dy[3][2];
+    DoublePoint p[3] = {a, b, c};
+    for(int k = 0; k < 3; k++) {
+        twoDiff(p[k].x, d.x, dx[k][1], dx[k][0]);
+        twoDiff(p[k].y, d.y, dy[k][1], dy[k][0]);
+    }
+
+    //Sum over k of lift(k) * cross(k + 1, k + 2)
+    double det[3 * EXPANSION_TERM], next[3 * EXPANSION_TERM];
+    int n = 0;
+    for(int k = 0; k < 3; k++) {
+        int k1 = (k + 1) % 3, k2 = (k + 2) % 3;
+        double xx[8], yy[8], lift[16], cross[16], term[EXPANSION_TERM];
+        int xxLen = expansionProduct(2, dx[k], 2, dx[k], xx);
+        int yyLen = expansionProduct(2, dy[k], 2, dy[k], yy);
+        int liftLen = expansionSum(xxLen, xx, yyLen, yy, lift);
+        int crossLen = crossExact(dx[k1], dy[k1], dx[k2], dy[k2], cross);
+        int termLen = expansionProduct(liftLen, lift, crossLen, cross, term);
+        if(n == 0) {
+            for(int i = 0; i < termLen; i++) det[i] = term[i];
+            n = termLen;
+        }
+        else {
+            n = expansionSum(n, det, termLen, term, next);
+            for(int i = 0; i < n; i++) det[i] = next[i];
+        }
+    }
+    return signOf(det[n - 1]);
+}
+
+template <>
+int orient2d<double>(DoublePoint a, DoublePoint b, DoublePoint c) {
+    double left = (a.x - c.x) * (b.y - c.y);
+    double right = (a.y - c.y) * (b.x - c.x);
+    double det = left - right;
+    if(std::fabs(det) > orientBound * (std::fabs(left) + std::fabs(right))) return signOf(det);
+    return orient2dExact(a, b, c);
+}
+
+template <>
+int inCircle<double>(DoublePoint a, DoublePoint b, DoublePoint c, DoublePoint d) {
+    double adx = a.x - d.x, ady = a.y - d.y;
+    double bdx = b.x - d.x, bdy = b.y - d.y;
+    double cdx = c.x - d.x, cdy = c.y - d.y;
+
+    double alift = adx * adx + ady * ady;
+    double blift = bdx * bdx + bdy * bdy;
+    double clift = cdx * cdx + cdy * cdy;
+
+    double bc = bdx * cdy - cdx * bdy;
+    double ca = cdx * ady - adx * cdy;
+    double ab = adx * bdy - bdx * ady;
+    double det = alift * bc + blift * ca + clift * ab;
+
+    double permanent = (std::fabs(bdx * cdy) + std::fabs(cdx * bdy)) * alift
+                        + (std::fabs(cdx * ady) + std::fabs(adx * cdy)) * blift
+                        + (std::fabs(adx * bdy) + std::fabs(bdx * ady)) * clift;
+    int sign = std::fabs(det) > inCircleBound * permanent ? signOf(det) : inCircleExact(a, b, c, d);
+    return sign * orient2d(a, b, c);
+}
+
+template <>
+int orient2d<float>(FloatPoint a, FloatPoint b, FloatPoint c) {
+    return orient2d(DoublePoint(a.x, a.y), DoublePoint(b.x, b.y), DoublePoint(c.x, c.y));
+}
+
+template <>
+int inCircle<float>(FloatPoint a, FloatPoint b, FloatPoint c, FloatPoint d) {
+    return inCircle(DoublePoint(a.x, a.y), DoublePoint(b.x, b.y), DoublePoint(c.x, c.y), DoublePoint(d.x, d.y));
+}
+
+static bool isGridCoord(double v) {
+    return v == std::floor(v) && std::fabs(v) <= GRID_COORD_LIMIT;
+}
+
+bool isGridPoint(const Point& p) {
+    return isGridCoord(p.x) && isGridCoord(p.y);
+}
+
+int orient2d(const Point& a, const Point& b, const Point& c) {
+    if(isGridPoint(a) && isGridPoint(b) && isGridPoint(c)) {
+        return orient2d(GridPoint(a), GridPoint(b), GridPoint(c));
+    }
+    return orient2d(DoublePoint(a), DoublePoint(b), DoublePoint(c));
+}
+
+int inCircle(const Point& a, const Point& b, const Point& c, const Point& d) {
+    if(isGridPoint(a) && isGridPoint(b) && isGridPoint(c) && isGridPoint(d)) {
+        return inCircle(GridPoint(a), GridPoint(b), GridPoint(c), GridPoint(d));
+    }
+    return inCircle(DoublePoint(a), DoublePoint(b), DoublePoint(c), DoublePoint(d));
+}
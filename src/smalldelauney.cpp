@@ -0,0 +1,38 @@
+#include <vector>
+
+#include <SDL2/SDL.h>
+
+#include "main.hpp"
+#include "smalldelauney.hpp"
+
+template <int N, typename T>
+static bool triangulateSmall(const std::vector<Point>& sites, std::vector<Triangle>& out) {
+    SmallDelauney<N, T> small;
+    if(!small.triangulate(sites.data(), (int) sites.size())) return false;
+    out.reserve(out.size() + small.triangleCount());
+    for(int i = 0; i < small.triangleCount(); i++) out.push_back(small.triangle(i));
+    return true;
+}
+
+template <typename T>
+static bool triangulateSmall(const std::vector<Point>& sites, std::vector<Triangle>& out) {
+    if(sites.size() <= 8) return triangulateSmall<8, T>(sites, out);
+    if(sites.size() <= 16) return triangulateSmall<16, T>(sites, out);
+    return triangulateSmall<32, T>(sites, out);
+}
+
+void delauneySmall(const std::vector<Point>& sites, std::vector<Triangle>& out) {
+    if(sites.size() <= 32) {
+        bool grid = true;
+        for(size_t i = 0; i < sites.size() && grid; i++) grid = isGridPoint(sites[i]);
+        if(grid ? triangulateSmall<int32_t>(sites, out) : triangulateSmall<double>(sites, out)) return;
+    }
+    std::vector<Triangle> general = delauney(sites);
+    out.insert(out.end(), general.begin(), general.end());
+}
+
+std::vector<Triangle> delauneySmall(const std::vector<Point>& sites) {
+    std::vector<Triangle> out;
+    delauneySmall(sites, out);
+    return out;
+}
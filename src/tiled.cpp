@@ -0,0 +1,433 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "tiled.hpp"
+#include "analytics.hpp"
+#include "mesh.hpp"
+#include "parallel.hpp"
+#include "predicates.hpp"
+
+//Rounds of sending conflict sites before a tile is simply sent every site
+#define TILE_MAX_ROUNDS 8
+
+//Rect class
+Rect::Rect() : minX(0), minY(0), maxX(0), maxY(0) {}
+
+Rect::Rect(double minX, double minY, double maxX, double maxY) : minX(minX), minY(minY), maxX(maxX), maxY(maxY) {}
+
+bool Rect::contains(const Point& p) const {
+    return p.x >= minX && p.x <= maxX && p.y >= minY && p.y <= maxY;
+}
+
+bool Rect::contains(const Rect& r) const {
+    return r.minX >= minX && r.maxX <= maxX && r.minY >= minY && r.maxY <= maxY;
+}
+
+Rect Rect::unite(const Rect& r) const {
+    return Rect(std::min(minX, r.minX), std::min(minY, r.minY), std::max(maxX, r.maxX), std::max(maxY, r.maxY));
+}
+
+Rect Rect::intersect(const Rect& r) const {
+    return Rect(std::max(minX, r.minX), std::max(minY, r.minY), std::min(maxX, r.maxX), std::min(maxY, r.maxY));
+}
+
+std::ostream& operator<<(std::ostream& os, const Rect& r) {
+    os << r.minX << " " << r.minY << " " << r.maxX << " " << r.maxY;
+    return os;
+}
+
+std::istream& operator>>(std::istream& is, Rect& r) {
+    is >> r.minX >> r.minY >> r.maxX >> r.maxY;
+    return is;
+}
+
+//TileReport class
+TileReport::TileReport() : rounds(0), maxSites(0), wholeDomain(false) {}
+
+static void writeTriangle(std::ostream& os, const Triangle& t) {
+    os << t.a.x << " " << t.a.y << " " << t.b.x << " " << t.b.y << " " << t.c.x << " " << t.c.y << "\n";
+}
+
+static bool readTriangle(std::istream& is, std::vector<Triangle>& out) {
+    double x1, y1, x2, y2, x3, y3;
+    if(!(is >> x1 >> y1 >> x2 >> y2 >> x3 >> y3)) return false;
+    out.push_back(Triangle(Point(x1, y1), Point(x2, y2), Point(x3, y3)));
+    return true;
+}
+
+//A triangle's corners ordered by x then y, so the same triangle gives the
+//same key whichever corner it is listed from
+static std::array<double, 6> triangleKey(const Point& a, const Point& b, const Point& c) {
+    Point p[3] = {a, b, c};
+    std::sort(p, p + 3, [](const Point& u, const Point& v) { return u.x < v.x || (u.x == v.x && u.y < v.y); });
+    return {{p[0].x, p[0].y, p[1].x, p[1].y, p[2].x, p[2].y}};
+}
+
+//Tiles are half open on their max sides, except along the domain's own
+//max edges, so every site belongs to exactly one tile
+static bool ownsPoint(const Rect& tile, const Rect& domain, const Point& p) {
+    bool inX = p.x >= tile.minX && (p.x < tile.maxX || (tile.maxX >= domain.maxX && p.x <= tile.maxX));
+    bool inY = p.y >= tile.minY && (p.y < tile.maxY || (tile.maxY >= domain.maxY && p.y <= tile.maxY));
+    return inX && inY;
+}
+
+//Bounding box of the part of a circle that lies inside rect, which is far
+//tighter than the circle's own box clipped to rect when the circle is huge
+//(as it is for triangles on the hull). False if they don't overlap.
+static bool circleInRect(const Point& center, double radius, const Rect& rect, Rect& extent) {
+    std::vector<Point> candidates;
+    double r2 = radius * radius;
+
+    Point corners[4] = {Point(rect.minX, rect.minY), Point(rect.maxX, rect.minY), Point(rect.minX, rect.maxY), Point(rect.maxX, rect.maxY)};
+    for(const Point& c : corners) {
+        double dx = c.x - center.x, dy = c.y - center.y;
+        if(dx * dx + dy * dy <= r2) candidates.push_back(c);
+    }
+
+    Point extremes[4] = {Point(center.x - radius, center.y), Point(center.x + radius, center.y),
+                            Point(center.x, center.y - radius), Point(center.x, center.y + radius)};
+    for(const Point& e : extremes) {
+        if(rect.contains(e)) candidates.push_back(e);
+    }
+
+    //Where the circle crosses each side of rect
+    double xs[2] = {rect.minX, rect.maxX};
+    for(double x : xs) {
+        double h = r2 - (x - center.x) * (x - center.x);
+        if(h < 0) continue;
+        candidates.push_back(Point(x, center.y - std::sqrt(h)));
+        candidates.push_back(Point(x, center.y + std::sqrt(h)));
+    }
+    double ys[2] = {rect.minY, rect.maxY};
+    for(double y : ys) {
+        double h = r2 - (y - center.y) * (y - center.y);
+        if(h < 0) continue;
+        candidates.push_back(Point(center.x - std::sqrt(h), y));
+        candidates.push_back(Point(center.x + std::sqrt(h), y));
+    }
+
+    bool found = false;
+    for(const Point& c : candidates) {
+        if(!rect.contains(c)) continue;
+        extent = found ? extent.unite(Rect(c.x, c.y, c.x, c.y)) : Rect(c.x, c.y, c.x, c.y);
+        found = true;
+    }
+    return found;
+}
+
+int runTileWorker(const std::string& inputFile, const std::string& outputFile) {
+    std::ifstream in(inputFile);
+    std::string label;
+    Rect tile, region, domain;
+    size_t numPoints = 0, numChecked = 0;
+    in >> label >> tile >> label >> region >> label >> domain >> label >> numPoints;
+
+    std::vector<Point> points(numPoints);
+    for(size_t i = 0; i < numPoints; i++) {
+        in >> points[i].x >> points[i].y;
+    }
+    in >> label >> numChecked;
+    std::vector<Triangle> checkedList;
+    for(size_t i = 0; i < numChecked && in; i++) {
+        readTriangle(in, checkedList);
+    }
+    if(!in) {
+        std::cout << "Tile worker couldn't read " << inputFile << "\n";
+        return 1;
+    }
+    std::set<std::array<double, 6>> checked;
+    for(const Triangle& t : checkedList) {
+        checked.insert(triangleKey(t.a, t.b, t.c));
+    }
+
+    Mesh mesh(domain.minX, domain.minY, domain.maxX, domain.maxY);
+    mesh.insertBatch(points, 1);
+
+    //Once the region is the whole domain there is nothing left unseen
+    bool complete = region.contains(domain);
+
+    //A tile is done once the whole star of every site it owns is certified:
+    //then those stars match the global triangulation, and with them every
+    //triangle the tile owns.
+    std::vector<Triangle> certified;
+    std::vector<Triangle> uncertified;
+    std::vector<int> triangles = mesh.triangleVertices();
+    for(size_t t = 0; t < triangles.size(); t += 3) {
+        const int* v = &triangles[t];
+        int numCorners = 0, low = -1;
+        bool touchesOwned = false;
+        for(int k = 0; k < 3; k++) {
+            if(v[k] < SUPER_CORNERS) {
+                numCorners++;
+                continue;
+            }
+            const Point& p = mesh.vertex(v[k]);
+            if(ownsPoint(tile, domain, p)) touchesOwned = true;
+            if(low < 0 || p.x < mesh.vertex(low).x || (p.x == mesh.vertex(low).x && p.y < mesh.vertex(low).y)) low = v[k];
+        }
+        if(!touchesOwned) continue;
+
+        //Triangles with a supertriangle corner need no check. Every tile is
+        //sent all sites on the global hull, including those along its edges,
+        //so the local hull is the global one. What such a triangle stands
+        //for is then empty everywhere: with one corner the half plane beyond
+        //a hull edge, with two the sites past the most extreme one.
+        if(numCorners > 0) continue;
+
+        //Sites can only be inside the domain, so only the part of the
+        //circumcircle inside it has to be covered by the region, unless the
+        //coordinator already checked this circle against every site
+        const Point& a = mesh.vertex(v[0]);
+        const Point& b = mesh.vertex(v[1]);
+        const Point& c = mesh.vertex(v[2]);
+        bool sure = complete || checked.count(triangleKey(a, b, c)) > 0;
+        if(!sure) {
+            Point center = circumcenter(a, b, c);
+            double dx = center.x - a.x, dy = center.y - a.y;
+            double radius = std::sqrt(dx * dx + dy * dy) * (1 + 1e-9);
+            Rect need;
+            sure = !circleInRect(center, radius, domain, need) || region.contains(need);
+        }
+
+        if(!sure) {
+            uncertified.push_back(Triangle(a, b, c));
+        }
+        else if(ownsPoint(tile, domain, mesh.vertex(low))) {
+            //Reported only by the tile owning its lowest corner, so exactly
+            //one tile outputs each triangle
+            certified.push_back(Triangle(a, b, c));
+        }
+    }
+
+    std::ofstream out(outputFile);
+    out << std::setprecision(17);
+    out << "certified " << certified.size() << "\n";
+    for(const Triangle& t : certified) {
+        writeTriangle(out, t);
+    }
+    out << "uncertified " << uncertified.size() << "\n";
+    for(const Triangle& t : uncertified) {
+        writeTriangle(out, t);
+    }
+    return out ? 0 : 1;
+}
+
+bool delauneyTiled(const std::vector<Point>& sites, int tilesX, int tilesY, const std::string& workDir,
+                    const std::string& workerExe, std::vector<Triangle>& out) {
+    std::vector<TileReport> reports;
+    return delauneyTiled(sites, tilesX, tilesY, workDir, workerExe, out, reports);
+}
+
+bool delauneyTiled(const std::vector<Point>& sites, int tilesX, int tilesY, const std::string& workDir,
+                    const std::string& workerExe, std::vector<Triangle>& out, std::vector<TileReport>& reports) {
+    out.clear();
+    reports.clear();
+    if(sites.empty()) return true;
+
+    Rect domain(sites[0].x, sites[0].y, sites[0].x, sites[0].y);
+    for(const Point& p : sites) {
+        domain = domain.unite(Rect(p.x, p.y, p.x, p.y));
+    }
+    if(domain.maxX == domain.minX) tilesX = 1;
+    if(domain.maxY == domain.minY) tilesY = 1;
+    double tileW = (domain.maxX - domain.minX) / tilesX;
+    double tileH = (domain.maxY - domain.minY) / tilesY;
+    double halo = 0.25 * std::max(tileW, tileH);
+    double diagonal = std::hypot(domain.maxX - domain.minX, domain.maxY - domain.minY);
+
+    int numTiles = tilesX * tilesY;
+    std::vector<Rect> tiles, regions;
+    std::vector<int> pending;
+    for(int ty = 0; ty < tilesY; ty++) {
+        for(int tx = 0; tx < tilesX; tx++) {
+            //Last row and column end exactly on the domain so rounding can't
+            //leave a sliver of sites unowned
+            Rect tile(domain.minX + tx * tileW, domain.minY + ty * tileH,
+                        tx == tilesX - 1 ? domain.maxX : domain.minX + (tx + 1) * tileW,
+                        ty == tilesY - 1 ? domain.maxY : domain.minY + (ty + 1) * tileH);
+            tiles.push_back(tile);
+            regions.push_back(Rect(tile.minX - halo, tile.minY - halo, tile.maxX + halo, tile.maxY + halo).intersect(domain));
+            pending.push_back((int) tiles.size() - 1);
+        }
+    }
+    reports.assign(numTiles, TileReport());
+
+    //Every tile gets the sites on the global hull (see runTileWorker)
+    std::vector<Point> hull = hullSites(sites);
+    std::vector<char> onGlobalHull(sites.size());
+    for(size_t i = 0; i < sites.size(); i++) {
+        onGlobalHull[i] = std::binary_search(hull.begin(), hull.end(), sites[i], [](const Point& u, const Point& v) {
+            return u.x < v.x || (u.x == v.x && u.y < v.y);
+        });
+    }
+
+    //Sites bucketed on a grid over the domain, so the ones inside a circle
+    //are found without testing every site
+    int gridSide = std::max(1, (int) std::sqrt(sites.size() / 4.0));
+    auto gridCell = [&](double v, double lo, double hi) {
+        double f = hi > lo ? (v - lo) / (hi - lo) * gridSide : 0;
+        return f < 0 ? 0 : f >= gridSide ? gridSide - 1 : (int) f;
+    };
+    std::vector<int> cellStart(gridSide * gridSide + 1, 0), cellSites(sites.size());
+    for(const Point& p : sites) {
+        cellStart[gridCell(p.y, domain.minY, domain.maxY) * gridSide + gridCell(p.x, domain.minX, domain.maxX) + 1]++;
+    }
+    for(int c = 0; c < gridSide * gridSide; c++) {
+        cellStart[c + 1] += cellStart[c];
+    }
+    std::vector<int> cellFill(cellStart.begin(), cellStart.end() - 1);
+    for(size_t i = 0; i < sites.size(); i++) {
+        const Point& p = sites[i];
+        cellSites[cellFill[gridCell(p.y, domain.minY, domain.maxY) * gridSide + gridCell(p.x, domain.minX, domain.maxX)]++] = (int) i;
+    }
+
+    //Marks every site on or inside the circumcircle of t, tested exactly.
+    //The circle only narrows down which grid cells are searched. Rounding
+    //moves its center and radius by a tiny fraction of the radius, which
+    //the padding far exceeds, so no site inside can be missed.
+    auto markInCircle = [&](const Triangle& t, std::vector<char>& mark) {
+        Point center = circumcenter(t.a, t.b, t.c);
+        double radius = std::hypot(center.x - t.a.x, center.y - t.a.y);
+        radius += 1e-9 * radius + 1e-9 * diagonal;
+        bool bounded = std::isfinite(radius) && std::isfinite(center.x) && std::isfinite(center.y);
+        int winding = orient2d(t.a, t.b, t.c);
+        for(int row = 0; row < gridSide; row++) {
+            //Columns the circle reaches within this row of cells
+            int colLow = 0, colHigh = gridSide - 1;
+            if(bounded) {
+                double rowLow = domain.minY + (domain.maxY - domain.minY) * row / gridSide;
+                double rowHigh = domain.minY + (domain.maxY - domain.minY) * (row + 1) / gridSide;
+                double dy = std::max(0.0, std::max(rowLow - center.y, center.y - rowHigh));
+                if(dy > radius) continue;
+                double halfWidth = std::sqrt((radius - dy) * (radius + dy));
+                if(center.x + halfWidth < domain.minX || center.x - halfWidth > domain.maxX) continue;
+                colLow = gridCell(center.x - halfWidth, domain.minX, domain.maxX);
+                colHigh = gridCell(center.x + halfWidth, domain.minX, domain.maxX);
+            }
+            for(int col = colLow; col <= colHigh; col++) {
+                int c = row * gridSide + col;
+                for(int j = cellStart[c]; j < cellStart[c + 1]; j++) {
+                    int i = cellSites[j];
+                    if(!mark[i] && inCircle(t.a, t.b, t.c, sites[i]) * winding >= 0) mark[i] = 1;
+                }
+            }
+        }
+    };
+
+    //Circumcircles each tile asked about, and the sites found inside them
+    std::vector<std::vector<Triangle>> checked(numTiles);
+    std::vector<std::vector<char>> conflicts(numTiles);
+
+    std::vector<std::vector<Triangle>> accepted(numTiles);
+    for(int round = 0; !pending.empty(); round++) {
+        std::vector<std::string> inputs, outputs;
+        //Leaves nothing of this round behind in workDir when giving up
+        auto removeRoundFiles = [&]() {
+            for(const std::string& file : inputs) std::remove(file.c_str());
+            for(const std::string& file : outputs) std::remove(file.c_str());
+        };
+        for(int t : pending) {
+            if(round >= TILE_MAX_ROUNDS) {
+                regions[t] = domain;
+                reports[t].wholeDomain = true;
+            }
+
+            //The coordinator stands in for the halo exchange: each tile is
+            //sent its own sites plus everyone else's inside its region, on
+            //the global hull, or inside a circumcircle it asked about
+            std::string base = workDir + "/tile_" + std::to_string(t);
+            inputs.push_back(base + "_in.txt");
+            outputs.push_back(base + "_out.txt");
+            std::vector<const Point*> send;
+            for(size_t i = 0; i < sites.size(); i++) {
+                if(regions[t].contains(sites[i]) || onGlobalHull[i] || (!conflicts[t].empty() && conflicts[t][i])) send.push_back(&sites[i]);
+            }
+            reports[t].rounds++;
+            reports[t].maxSites = std::max(reports[t].maxSites, send.size());
+
+            std::ofstream in(inputs.back());
+            in << std::setprecision(17);
+            in << "tile " << tiles[t] << "\nregion " << regions[t] << "\ndomain " << domain << "\npoints " << send.size() << "\n";
+            for(const Point* p : send) {
+                in << p->x << " " << p->y << "\n";
+            }
+            in << "checked " << checked[t].size() << "\n";
+            for(const Triangle& tri : checked[t]) {
+                writeTriangle(in, tri);
+            }
+            if(!in) {
+                std::cout << "Couldn't write tile input " << inputs.back() << "\n";
+                in.close();
+                removeRoundFiles();
+                return false;
+            }
+        }
+
+        //Pending tiles run together, at most one per hardware thread
+        std::vector<int> status(pending.size());
+        parallelFor(pending.size(), std::min((int) pending.size(), defaultThreadCount()), [&](int /*worker*/, size_t k) {
+            if(workerExe.empty()) {
+                status[k] = runTileWorker(inputs[k], outputs[k]);
+            }
+            else {
+                std::string cmd = "\"" + workerExe + "\" --tile-worker \"" + inputs[k] + "\" \"" + outputs[k] + "\"";
+                status[k] = std::system(cmd.c_str());
+            }
+        });
+
+        std::vector<int> next;
+        for(size_t k = 0; k < pending.size(); k++) {
+            int t = pending[k];
+            std::ifstream result(outputs[k]);
+            std::string label;
+            size_t numCertified = 0, numUncertified = 0;
+            result >> label >> numCertified;
+
+            accepted[t].clear();
+            for(size_t i = 0; i < numCertified && result; i++) {
+                readTriangle(result, accepted[t]);
+            }
+
+            //Only the sites inside circumcircles that weren't certified can
+            //change the tile's stars, so exactly those are added
+            result >> label >> numUncertified;
+            size_t numChecked = checked[t].size();
+            for(size_t i = 0; i < numUncertified && result; i++) {
+                readTriangle(result, checked[t]);
+            }
+
+            if(status[k] != 0 || !result) {
+                std::cout << "Tile " << t << " worker failed\n";
+                result.close();
+                removeRoundFiles();
+                return false;
+            }
+            result.close();
+            std::remove(inputs[k].c_str());
+            std::remove(outputs[k].c_str());
+
+            if(numUncertified > 0) {
+                if(conflicts[t].empty()) conflicts[t].assign(sites.size(), 0);
+                for(size_t i = numChecked; i < checked[t].size(); i++) {
+                    markInCircle(checked[t][i], conflicts[t]);
+                }
+                next.push_back(t);
+            }
+        }
+        pending = next;
+    }
+
+    for(const std::vector<Triangle>& tris : accepted) {
+        out.insert(out.end(), tris.begin(), tris.end());
+    }
+    return true;
+}